@@ -0,0 +1,398 @@
+#include "AsyncSystem.hpp"
+#include "ECS.hpp"
+#include "Events.hpp"
+#include "Prefab.hpp"
+#include "Query.hpp"
+#include "Resource.hpp"
+#include "SpatialIndex.hpp"
+#include "ValueIndex.hpp"
+#include "World.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Position : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	float x = 0.0F;
+	float y = 0.0F;
+	float z = 0.0F;
+
+	Position() = default;
+
+	Position(float x, float y, float z)
+		: x(x), y(y), z(z) { }
+};
+
+class Velocity : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	float x = 1.0F;
+	float y = 1.0F;
+	float z = 1.0F;
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Helpers ----------------------------------
+// -----------------------------------------------------------------------------
+
+constexpr int64_t MIN_ENTITIES = 1000;
+constexpr int64_t MAX_ENTITIES = 10000000;
+constexpr int64_t ENTITY_MULTIPLIER = 10;
+constexpr uint32_t RANDOM_SEED = 42;
+
+/**
+ * @brief Activate an empty world with all benchmark components registered
+ * @param preallocCount The amount of components to preallocate per store
+*/
+static void ResetWorld(size_t preallocCount = 1) {
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	Junia::Component::Register<Position>(preallocCount);
+	Junia::Component::Register<Velocity>(preallocCount);
+}
+
+/**
+ * @brief Create entities with a Position component
+ * @param count The amount of entities to create
+ * @param velocityEvery Every n-th entity also gets a Velocity (0 for none)
+ * @return The created entities
+*/
+static std::vector<Junia::Entity> CreateEntities(size_t count, size_t velocityEvery = 0) {
+	std::vector<Junia::Entity> entities{ };
+	entities.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		Junia::Entity entity = Junia::Entity::Create();
+		entity.AddComponent<Position>(static_cast<float>(i), 0.0F, 0.0F);
+		if (velocityEvery != 0 && i % velocityEvery == 0) entity.AddComponent<Velocity>();
+		entities.push_back(entity);
+	}
+	return entities;
+}
+
+static std::vector<Junia::Entity> Shuffled(std::vector<Junia::Entity> entities) {
+	std::mt19937 random(RANDOM_SEED);
+	std::shuffle(entities.begin(), entities.end(), random);
+	return entities;
+}
+
+static void EntityCounts(benchmark::internal::Benchmark* benchmark) {
+	benchmark->RangeMultiplier(ENTITY_MULTIPLIER)->Range(MIN_ENTITIES, MAX_ENTITIES)
+		->Unit(benchmark::kMillisecond);
+}
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Benchmarks --------------------------------
+// -----------------------------------------------------------------------------
+
+static void BM_CreateDestroyEntities(benchmark::State& state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	ResetWorld(count);
+	for (auto _ : state) {
+		const std::vector<Junia::Entity> entities = CreateEntities(count);
+		for (const Junia::Entity entity : entities) Junia::Entity::DestroyEntity(entity);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CreateDestroyEntities)->Apply(EntityCounts);
+
+static void BM_AddRemoveComponent(benchmark::State& state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	ResetWorld(count);
+	std::vector<Junia::Entity> entities = CreateEntities(count);
+	for (auto _ : state) {
+		for (Junia::Entity entity : entities) entity.AddComponent<Velocity>();
+		for (Junia::Entity entity : entities) entity.RemoveComponent<Velocity>();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AddRemoveComponent)->Apply(EntityCounts);
+
+static void BM_StoreGrowth(benchmark::State& state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		ResetWorld();
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(CreateEntities(count));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StoreGrowth)->Apply(EntityCounts);
+
+static void BM_RandomGetComponent(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::vector<Junia::Entity> entities = Shuffled(CreateEntities(static_cast<size_t>(state.range(0))));
+	for (auto _ : state) {
+		float sum = 0.0F;
+		for (Junia::Entity entity : entities) sum += entity.GetComponent<Position>().x;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RandomGetComponent)->Apply(EntityCounts);
+
+static void BM_RandomReadComponent(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	const std::vector<Junia::Entity> entities = Shuffled(CreateEntities(static_cast<size_t>(state.range(0))));
+	for (auto _ : state) {
+		float sum = 0.0F;
+		for (const Junia::Entity entity : entities) sum += entity.ReadComponent<Position>().x;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RandomReadComponent)->Apply(EntityCounts);
+
+static void BM_ComponentRefDeref(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::vector<Junia::ComponentRef<Position>> references{ };
+	for (const Junia::Entity entity : CreateEntities(static_cast<size_t>(state.range(0))))
+		references.emplace_back(entity);
+	for (auto _ : state) {
+		float sum = 0.0F;
+		for (auto& reference : references) sum += reference->x;
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComponentRefDeref)->Apply(EntityCounts);
+
+static void BM_IterateEntities(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::vector<Junia::Entity> entities = CreateEntities(static_cast<size_t>(state.range(0)));
+	for (auto _ : state) {
+		for (Junia::Entity entity : entities) entity.GetComponent<Position>().x += 1.0F;
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IterateEntities)->Apply(EntityCounts);
+
+static void BM_JoinPositionVelocity(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::vector<Junia::Entity> entities = CreateEntities(static_cast<size_t>(state.range(0)), 2);
+	for (auto _ : state) {
+		for (Junia::Entity entity : entities) {
+			if (!entity.HasComponent<Velocity>()) continue;
+			const Velocity& velocity = entity.ReadComponent<Velocity>();
+			Position& position = entity.GetComponent<Position>();
+			position.x += velocity.x;
+			position.y += velocity.y;
+			position.z += velocity.z;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JoinPositionVelocity)->Apply(EntityCounts);
+
+static void BM_QueryPositionVelocity(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateEntities(static_cast<size_t>(state.range(0)), 2);
+	Junia::Query<Position, Velocity> query{ };
+	for (auto _ : state) {
+		query.ForEach([](Junia::Entity, Position& position, Velocity& velocity) -> void {
+			position.x += velocity.x;
+			position.y += velocity.y;
+			position.z += velocity.z;
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueryPositionVelocity)->Apply(EntityCounts);
+
+static void BM_ToggleEnabledQuery(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::vector<Junia::Entity> entities = CreateEntities(static_cast<size_t>(state.range(0)), 1);
+	Junia::Query<Position, Velocity> query{ };
+	bool enabled = false;
+	for (auto _ : state) {
+		// culls every other entity, then the next frame brings them back
+		for (size_t i = 0; i < entities.size(); i += 2) entities[i].SetEnabled(enabled);
+		enabled = !enabled;
+		query.ForEach([](Junia::Entity, Position& position, Velocity& velocity) -> void {
+			position.x += velocity.x;
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ToggleEnabledQuery)->Apply(EntityCounts);
+
+static void BM_SpatialQueryRadius(benchmark::State& state) {
+	constexpr size_t QUERY_COUNT = 1000;
+	constexpr float WORLD_SIZE = 1000.0F;
+	constexpr float QUERY_RADIUS = 5.0F;
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	std::mt19937 random(RANDOM_SEED);
+	std::uniform_real_distribution<float> coordinate(0.0F, WORLD_SIZE);
+	for (int64_t i = 0; i < state.range(0); i++)
+		Junia::Entity::Create().AddComponent<Position>(coordinate(random), coordinate(random), 0.0F);
+	Junia::SpatialIndex<Position> index(QUERY_RADIUS * 2.0F, [](const Position& position) -> Junia::SpatialPoint {
+		return { position.x, position.y, position.z };
+	});
+	for (auto _ : state) {
+		for (size_t i = 0; i < QUERY_COUNT; i++) {
+			benchmark::DoNotOptimize(index.QueryRadius(
+				{ coordinate(random), coordinate(random), 0.0F }, QUERY_RADIUS));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * QUERY_COUNT);
+}
+BENCHMARK(BM_SpatialQueryRadius)->Apply(EntityCounts);
+
+/**
+ * @brief The amount of lookups per iteration of the value lookup benchmarks
+*/
+constexpr size_t LOOKUP_COUNT = 10;
+
+/**
+ * @brief Create entities with a Position whose x is the index of the entity
+ * @param count The amount of entities to create
+*/
+static void CreateNumberedEntities(size_t count) {
+	for (size_t i = 0; i < count; i++)
+		Junia::Entity::Create().AddComponent<Position>(static_cast<float>(i), 0.0F, 0.0F);
+}
+
+static void BM_ValueIndexLookup(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateNumberedEntities(static_cast<size_t>(state.range(0)));
+	Junia::ValueIndex<Position, int64_t> index([](const Position& position) -> int64_t {
+		return static_cast<int64_t>(position.x);
+	});
+	// the index is filled on the first lookup
+	benchmark::DoNotOptimize(index.Count(0));
+	std::mt19937 random(RANDOM_SEED);
+	std::uniform_int_distribution<int64_t> key(0, state.range(0) - 1);
+	for (auto _ : state) {
+		for (size_t i = 0; i < LOOKUP_COUNT; i++) benchmark::DoNotOptimize(index.FindFirst(key(random)));
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUP_COUNT);
+}
+BENCHMARK(BM_ValueIndexLookup)->Apply(EntityCounts);
+
+static void BM_LinearScanLookup(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateNumberedEntities(static_cast<size_t>(state.range(0)));
+	Junia::Query<Position> query{ };
+	std::mt19937 random(RANDOM_SEED);
+	std::uniform_int_distribution<int64_t> key(0, state.range(0) - 1);
+	for (auto _ : state) {
+		for (size_t i = 0; i < LOOKUP_COUNT; i++) {
+			const int64_t wanted = key(random);
+			std::vector<Junia::Entity> found{ };
+			query.ForEach([wanted, &found](Junia::Entity entity, Position& position) -> void {
+				if (static_cast<int64_t>(position.x) == wanted) found.push_back(entity);
+			});
+			benchmark::DoNotOptimize(found);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * LOOKUP_COUNT);
+}
+BENCHMARK(BM_LinearScanLookup)->Apply(EntityCounts);
+
+static void BM_DoubleBufferedEndFrame(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateEntities(static_cast<size_t>(state.range(0)));
+	Junia::Component::SetDoubleBuffered<Position>();
+	for (auto _ : state) Junia::World::GetActive()->EndFrame();
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DoubleBufferedEndFrame)->Apply(EntityCounts);
+
+static void BM_SingletonComponent(benchmark::State& state) {
+	ResetWorld();
+	Junia::Entity singleton = Junia::Entity::Create();
+	singleton.AddComponent<Velocity>();
+	for (auto _ : state) benchmark::DoNotOptimize(singleton.ReadComponent<Velocity>().x);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SingletonComponent);
+
+static void BM_ReadResource(benchmark::State& state) {
+	ResetWorld();
+	Junia::SetResource<Velocity>();
+	for (auto _ : state) benchmark::DoNotOptimize(Junia::ReadResource<Velocity>().x);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadResource);
+
+static void BM_SendReadEvents(benchmark::State& state) {
+	ResetWorld();
+	Junia::Events<Position> events{ };
+	Junia::EventReader<Position> reader = events.CreateReader();
+	for (auto _ : state) {
+		for (int64_t i = 0; i < state.range(0); i++) events.Send(static_cast<float>(i), 0.0F, 0.0F);
+		float sum = 0.0F;
+		reader.Read([&sum](const Position& position) -> void {
+			sum += position.x;
+		});
+		benchmark::DoNotOptimize(sum);
+		Junia::World::GetActive()->EndFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SendReadEvents)->Apply(EntityCounts);
+
+static Junia::AsyncSystem MoveEveryFrame(Junia::Entity entity) {
+	Junia::ComponentRef<Position> position(entity);
+	while (true) {
+		position->x += 1.0F;
+		co_await Junia::NextFrame(position);
+	}
+}
+
+static void BM_AsyncSystemFrames(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	for (const Junia::Entity entity : CreateEntities(static_cast<size_t>(state.range(0))))
+		Junia::StartAsyncSystem(MoveEveryFrame(entity));
+	for (auto _ : state) Junia::World::GetActive()->EndFrame();
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AsyncSystemFrames)->Apply(EntityCounts);
+
+static void BM_PrefabInstantiate(benchmark::State& state) {
+	const auto count = static_cast<size_t>(state.range(0));
+	Junia::Prefab prefab{ };
+	prefab.AddComponent<Position>(1.0F, 2.0F, 3.0F).AddComponent<Velocity>();
+	for (auto _ : state) {
+		state.PauseTiming();
+		ResetWorld();
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(prefab.Instantiate(count));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PrefabInstantiate)->Apply(EntityCounts);
+
+static void BM_ForkWorld(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateEntities(static_cast<size_t>(state.range(0)), 2);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Junia::World::GetActive()->Fork());
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ForkWorld)->Apply(EntityCounts);
+
+static void BM_SaveLoadSnapshot(benchmark::State& state) {
+	ResetWorld(static_cast<size_t>(state.range(0)));
+	CreateEntities(static_cast<size_t>(state.range(0)), 2);
+	for (auto _ : state) {
+		std::stringstream snapshot{ };
+		Junia::SaveSnapshot(snapshot);
+		Junia::LoadSnapshot(snapshot);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SaveLoadSnapshot)->Apply(EntityCounts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,187 @@
+#include "AsyncSystem.hpp"
+#include "World.hpp"
+
+#include <stdexcept>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Global functions -----------------------------
+// -----------------------------------------------------------------------------
+
+void StartAsyncSystem(AsyncSystem system) {
+	World::GetActiveWorld().GetAsyncScheduler().Start(std::move(system));
+}
+
+void SetAsyncJobExecutor(AsyncJobExecutor executor) {
+	World::GetActiveWorld().GetAsyncScheduler().SetJobExecutor(std::move(executor));
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+// ----------------------------- AsyncSystemPromise ----------------------------
+
+std::suspend_always AsyncSystemPromise::initial_suspend() noexcept {
+	return { };
+}
+
+std::suspend_always AsyncSystemPromise::final_suspend() noexcept {
+	return { };
+}
+
+void AsyncSystemPromise::return_void() { }
+
+void AsyncSystemPromise::unhandled_exception() {
+	exception = std::current_exception();
+}
+
+void AsyncSystemPromise::SetScheduler(AsyncScheduler& owner) {
+	scheduler = &owner;
+}
+
+AsyncScheduler& AsyncSystemPromise::GetScheduler() const {
+	if (scheduler == nullptr) throw std::runtime_error("async system has not been started");
+	return *scheduler;
+}
+
+void AsyncSystemPromise::Hold(bool (*function)(void*), void* awaiterAddress) {
+	revalidate = function;
+	awaiter = awaiterAddress;
+}
+
+bool AsyncSystemPromise::Revalidate() {
+	if (revalidate == nullptr) return true;
+	const bool valid = revalidate(awaiter);
+	revalidate = nullptr;
+	awaiter = nullptr;
+	return valid;
+}
+
+std::exception_ptr AsyncSystemPromise::TakeException() {
+	return std::exchange(exception, nullptr);
+}
+
+// -------------------------------- AsyncSystem --------------------------------
+
+AsyncSystem::AsyncSystem(AsyncSystemHandle handle)
+	: handle(handle) { }
+
+AsyncSystem::AsyncSystem(AsyncSystem&& other) noexcept
+	: handle(std::exchange(other.handle, nullptr)) { }
+
+AsyncSystem::~AsyncSystem() {
+	if (handle) handle.destroy();
+}
+
+AsyncSystem& AsyncSystem::operator=(AsyncSystem&& other) noexcept {
+	if (&other == this) return *this;
+	if (handle) handle.destroy();
+	handle = std::exchange(other.handle, nullptr);
+	return *this;
+}
+
+AsyncSystemHandle AsyncSystem::Release() {
+	return std::exchange(handle, nullptr);
+}
+
+// ------------------------------- AsyncJobInbox -------------------------------
+
+void AsyncJobInbox::Push(AsyncSystemHandle handle) {
+	const std::lock_guard<std::mutex> lock(mutex);
+	completed.push_back(handle);
+}
+
+std::vector<AsyncSystemHandle> AsyncJobInbox::Take() {
+	const std::lock_guard<std::mutex> lock(mutex);
+	return std::exchange(completed, { });
+}
+
+// ------------------------------- AsyncScheduler ------------------------------
+
+bool AsyncScheduler::Timer::operator>(const Timer& other) const {
+	return deadline > other.deadline;
+}
+
+AsyncScheduler::~AsyncScheduler() {
+	for (auto& jobThreadPair : jobThreads) jobThreadPair.second.join();
+	for (void* address : systems) AsyncSystemHandle::from_address(address).destroy();
+}
+
+void AsyncScheduler::Resume(AsyncSystemHandle handle, std::exception_ptr& exception) {
+	if (!handle.promise().Revalidate()) {
+		Destroy(handle);
+		return;
+	}
+	handle.resume();
+	if (!handle.done()) return;
+	std::exception_ptr thrown = handle.promise().TakeException();
+	Destroy(handle);
+	if (exception == nullptr) exception = std::move(thrown);
+}
+
+void AsyncScheduler::Destroy(AsyncSystemHandle handle) {
+	systems.erase(handle.address());
+	handle.destroy();
+}
+
+void AsyncScheduler::Start(AsyncSystem system) {
+	const AsyncSystemHandle handle = system.Release();
+	if (!handle) throw std::runtime_error("async system has already been started");
+	handle.promise().SetScheduler(*this);
+	systems.insert(handle.address());
+	std::exception_ptr exception{ };
+	Resume(handle, exception);
+	if (exception != nullptr) std::rethrow_exception(exception);
+}
+
+void AsyncScheduler::ScheduleNextFrame(AsyncSystemHandle handle) {
+	nextFrame.push_back(handle);
+}
+
+void AsyncScheduler::ScheduleAt(AsyncClock::time_point deadline, AsyncSystemHandle handle) {
+	timers.push({ deadline, handle });
+}
+
+void AsyncScheduler::RunJob(AsyncSystemHandle handle, std::function<void()> job) {
+	if (executor) executor(std::move(job));
+	else jobThreads.emplace(handle.address(), std::thread(std::move(job)));
+}
+
+void AsyncScheduler::SetJobExecutor(AsyncJobExecutor jobExecutor) {
+	executor = std::move(jobExecutor);
+}
+
+std::weak_ptr<AsyncJobInbox> AsyncScheduler::GetInbox() const {
+	return inbox;
+}
+
+size_t AsyncScheduler::GetCount() const {
+	return systems.size();
+}
+
+void AsyncScheduler::Update() {
+	// systems suspending again while being resumed wait for the frame after
+	std::vector<AsyncSystemHandle> due = std::exchange(nextFrame, { });
+	const AsyncClock::time_point now = AsyncClock::now();
+	while (!timers.empty() && timers.top().deadline <= now) {
+		due.push_back(timers.top().handle);
+		timers.pop();
+	}
+	for (const AsyncSystemHandle handle : inbox->Take()) {
+		// the job has handed the system back, its thread is about to exit
+		auto iterator = jobThreads.find(handle.address());
+		if (iterator != jobThreads.end()) {
+			iterator->second.join();
+			jobThreads.erase(iterator);
+		}
+		due.push_back(handle);
+	}
+
+	std::exception_ptr exception{ };
+	for (const AsyncSystemHandle handle : due) Resume(handle, exception);
+	if (exception != nullptr) std::rethrow_exception(exception);
+}
+
+} // namespace Junia
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "ECS.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief The clock timers of async systems are measured with
+*/
+using AsyncClock = std::chrono::steady_clock;
+
+/**
+ * @brief A function running a job on another thread (e.g. by handing it to a
+ *        thread pool)
+*/
+using AsyncJobExecutor = std::function<void(std::function<void()>)>;
+
+// Forward declarations for use in AsyncSystemPromise class
+class AsyncScheduler;
+class AsyncSystem;
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief INTERNAL USE ONLY - The promise of an async system coroutine
+*/
+class AsyncSystemPromise {
+private:
+	AsyncScheduler* scheduler = nullptr;
+
+	/**
+	 * @brief Revalidates the component references held by the awaiter the
+	 *        coroutine is suspended on (nullptr if it holds none)
+	*/
+	bool (*revalidate)(void*) = nullptr;
+	void* awaiter = nullptr;
+
+	std::exception_ptr exception{ };
+
+public:
+	AsyncSystem get_return_object();
+	std::suspend_always initial_suspend() noexcept;
+	std::suspend_always final_suspend() noexcept;
+	void return_void();
+	void unhandled_exception();
+
+	void SetScheduler(AsyncScheduler& owner);
+	[[nodiscard]] AsyncScheduler& GetScheduler() const;
+
+	/**
+	 * @brief Revalidate the references of an awaiter before resuming
+	 * @param function A function revalidating the references of the awaiter
+	 * @param awaiterAddress The awaiter passed to function
+	*/
+	void Hold(bool (*function)(void*), void* awaiterAddress);
+
+	/**
+	 * @brief Revalidate the held references (and stop holding them)
+	 * @return true if all references are still valid, false otherwise
+	*/
+	bool Revalidate();
+
+	[[nodiscard]] std::exception_ptr TakeException();
+};
+
+using AsyncSystemHandle = std::coroutine_handle<AsyncSystemPromise>;
+
+/**
+ * @brief A system running as a coroutine that can suspend across frames
+ *        (co_await Junia::NextFrame, Junia::Delay or Junia::Background).
+ *        Returned by coroutine functions and started with
+ *        Junia::StartAsyncSystem(), nothing runs before.
+*/
+class AsyncSystem {
+private:
+	AsyncSystemHandle handle{ };
+
+public:
+	using promise_type = AsyncSystemPromise;
+
+	explicit AsyncSystem(AsyncSystemHandle handle);
+	AsyncSystem(const AsyncSystem&) = delete;
+	AsyncSystem(AsyncSystem&& other) noexcept;
+
+	/**
+	 * @brief Destroy the coroutine if it has not been started
+	*/
+	~AsyncSystem();
+
+	AsyncSystem& operator=(const AsyncSystem&) = delete;
+	AsyncSystem& operator=(AsyncSystem&& other) noexcept;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Hand the coroutine over to a scheduler
+	 * @return The handle of the coroutine
+	*/
+	AsyncSystemHandle Release();
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Background jobs that have completed and whose
+ *        coroutines are to be resumed (filled by the job threads)
+*/
+class AsyncJobInbox {
+private:
+	std::mutex mutex{ };
+	std::vector<AsyncSystemHandle> completed{ };
+
+public:
+	void Push(AsyncSystemHandle handle);
+	std::vector<AsyncSystemHandle> Take();
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Owns the async systems of a world and resumes
+ *        them when what they wait for has happened (see World::EndFrame()).
+ *        Waiting systems are not looked at: systems waiting for the next
+ *        frame are kept in a list, timers in a heap ordered by deadline and
+ *        systems waiting for a job are handed back by the job.
+*/
+class AsyncScheduler {
+private:
+	struct Timer {
+		AsyncClock::time_point deadline{ };
+		AsyncSystemHandle handle{ };
+
+		bool operator>(const Timer& other) const;
+	};
+
+	/**
+	 * @brief The frames of all started systems that have not finished
+	*/
+	std::unordered_set<void*> systems{ };
+
+	std::vector<AsyncSystemHandle> nextFrame{ };
+	std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers{ };
+	std::shared_ptr<AsyncJobInbox> inbox = std::make_shared<AsyncJobInbox>();
+	AsyncJobExecutor executor{ };
+
+	/**
+	 * @brief The threads running jobs without an executor by the frame of
+	 *        the waiting system (joined once the job has completed)
+	*/
+	std::unordered_map<void*, std::thread> jobThreads{ };
+
+	/**
+	 * @brief Resume a system unless one of its held references has become
+	 *        invalid (then it is destroyed)
+	 * @param handle The system
+	 * @param exception Set to the exception thrown by the system (if none
+	 *                  has been set before)
+	*/
+	void Resume(AsyncSystemHandle handle, std::exception_ptr& exception);
+
+	void Destroy(AsyncSystemHandle handle);
+
+public:
+	AsyncScheduler() = default;
+	AsyncScheduler(const AsyncScheduler&) = delete;
+	AsyncScheduler(AsyncScheduler&&) = delete;
+
+	/**
+	 * @brief Wait for the jobs running on threads of their own, then destroy
+	 *        all systems that have not finished
+	*/
+	~AsyncScheduler();
+
+	AsyncScheduler& operator=(const AsyncScheduler&) = delete;
+	AsyncScheduler& operator=(AsyncScheduler&&) = delete;
+
+	void Start(AsyncSystem system);
+	void ScheduleNextFrame(AsyncSystemHandle handle);
+	void ScheduleAt(AsyncClock::time_point deadline, AsyncSystemHandle handle);
+	void RunJob(AsyncSystemHandle handle, std::function<void()> job);
+	void SetJobExecutor(AsyncJobExecutor jobExecutor);
+	[[nodiscard]] std::weak_ptr<AsyncJobInbox> GetInbox() const;
+	[[nodiscard]] size_t GetCount() const;
+
+	/**
+	 * @brief Resume the systems waiting for the next frame, whose timer has
+	 *        expired or whose job has completed (rethrows the first exception
+	 *        thrown by a system after all have been resumed)
+	*/
+	void Update();
+};
+
+/**
+ * @brief Start an async system in the active world: it runs until its first
+ *        co_await right away and is resumed by World::EndFrame() from then
+ *        on (which therefore must be called on the active world). Systems are
+ *        not copied to forks and are destroyed with their world.
+ * @param system The coroutine to start
+*/
+void StartAsyncSystem(AsyncSystem system);
+
+/**
+ * @brief Set how the active world runs the jobs of Junia::Background
+ *        (defaults to a thread per job, destroying the world waits for them)
+ * @param executor A function running the passed job on another thread
+*/
+void SetAsyncJobExecutor(AsyncJobExecutor executor);
+
+/**
+ * @brief INTERNAL USE ONLY - Holds the component references an async system
+ *        keeps across a suspension
+ * @tparam ...T The types of the referenced components
+*/
+template<TypenameDerivedFrom<Component>... T>
+class AsyncHeldRefs {
+private:
+	std::tuple<ComponentRef<T>*...> refs;
+
+	static bool Revalidate(void* awaiter);
+
+protected:
+	explicit AsyncHeldRefs(ComponentRef<T>&... refs);
+
+	void Hold(AsyncSystemHandle handle);
+};
+
+/**
+ * @brief Awaitable resuming an async system at the next frame boundary. The
+ *        system is destroyed instead if one of the passed references has lost
+ *        its component (the others are revalidated).
+ * @tparam ...T The types of the components referenced across the suspension
+*/
+template<TypenameDerivedFrom<Component>... T>
+class NextFrame : private AsyncHeldRefs<T...> {
+public:
+	explicit NextFrame(ComponentRef<T>&... refs);
+
+	[[nodiscard]] bool await_ready() const noexcept;
+	void await_suspend(AsyncSystemHandle handle);
+	void await_resume() const noexcept;
+};
+
+/**
+ * @brief Awaitable resuming an async system at the first frame boundary after
+ *        a duration has passed (references are handled like by
+ *        Junia::NextFrame)
+ * @tparam ...T The types of the components referenced across the suspension
+*/
+template<TypenameDerivedFrom<Component>... T>
+class Delay : private AsyncHeldRefs<T...> {
+private:
+	AsyncClock::time_point deadline;
+
+public:
+	template<typename TRep, typename TPeriod>
+	explicit Delay(std::chrono::duration<TRep, TPeriod> duration, ComponentRef<T>&... refs);
+
+	[[nodiscard]] bool await_ready() const noexcept;
+	void await_suspend(AsyncSystemHandle handle);
+	void await_resume() const noexcept;
+};
+
+/**
+ * @brief Awaitable running a function on another thread (see
+ *        Junia::SetAsyncJobExecutor()) and resuming the async system at the
+ *        first frame boundary after it has completed, with its result (or
+ *        rethrowing its exception). References are handled like by
+ *        Junia::NextFrame. The function must not use the ECS.
+ * @tparam TFunc The type of the function
+ * @tparam ...T The types of the components referenced across the suspension
+*/
+template<typename TFunc, TypenameDerivedFrom<Component>... T>
+class Background : private AsyncHeldRefs<T...> {
+private:
+	using ResultType = std::invoke_result_t<TFunc&>;
+	using StoredType = std::conditional_t<std::is_void_v<ResultType>, bool, ResultType>;
+
+	/**
+	 * @brief The outcome of the job (shared with the job, which may outlive
+	 *        the coroutine if the world is destroyed first)
+	*/
+	struct JobState {
+		std::optional<StoredType> result{ };
+		std::exception_ptr exception{ };
+	};
+
+	TFunc function;
+	std::shared_ptr<JobState> state = std::make_shared<JobState>();
+
+public:
+	explicit Background(TFunc function, ComponentRef<T>&... refs);
+
+	[[nodiscard]] bool await_ready() const noexcept;
+	void await_suspend(AsyncSystemHandle handle);
+	ResultType await_resume();
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// ----------------------------- AsyncHeldRefs<T> ------------------------------
+
+template<TypenameDerivedFrom<Component>... T>
+inline AsyncHeldRefs<T...>::AsyncHeldRefs(ComponentRef<T>&... refs)
+	: refs(&refs...) { }
+
+template<TypenameDerivedFrom<Component>... T>
+inline bool AsyncHeldRefs<T...>::Revalidate(void* awaiter) {
+	return std::apply([](ComponentRef<T>*... refs) -> bool {
+		return (refs->Revalidate() && ...);
+	}, static_cast<AsyncHeldRefs*>(awaiter)->refs);
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline void AsyncHeldRefs<T...>::Hold(AsyncSystemHandle handle) {
+	if constexpr (sizeof...(T) > 0) handle.promise().Hold(&Revalidate, this);
+}
+
+// -------------------------------- NextFrame<T> -------------------------------
+
+template<TypenameDerivedFrom<Component>... T>
+inline NextFrame<T...>::NextFrame(ComponentRef<T>&... refs)
+	: AsyncHeldRefs<T...>(refs...) { }
+
+template<TypenameDerivedFrom<Component>... T>
+inline bool NextFrame<T...>::await_ready() const noexcept {
+	return false;
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline void NextFrame<T...>::await_suspend(AsyncSystemHandle handle) {
+	this->Hold(handle);
+	handle.promise().GetScheduler().ScheduleNextFrame(handle);
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline void NextFrame<T...>::await_resume() const noexcept { }
+
+// ---------------------------------- Delay<T> ---------------------------------
+
+template<TypenameDerivedFrom<Component>... T>
+template<typename TRep, typename TPeriod>
+inline Delay<T...>::Delay(std::chrono::duration<TRep, TPeriod> duration, ComponentRef<T>&... refs)
+	: AsyncHeldRefs<T...>(refs...),
+	deadline(AsyncClock::now() + std::chrono::duration_cast<AsyncClock::duration>(duration)) { }
+
+template<TypenameDerivedFrom<Component>... T>
+inline bool Delay<T...>::await_ready() const noexcept {
+	return false;
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline void Delay<T...>::await_suspend(AsyncSystemHandle handle) {
+	this->Hold(handle);
+	handle.promise().GetScheduler().ScheduleAt(deadline, handle);
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline void Delay<T...>::await_resume() const noexcept { }
+
+// ----------------------------- Background<TFunc> -----------------------------
+
+template<typename TFunc, TypenameDerivedFrom<Component>... T>
+inline Background<TFunc, T...>::Background(TFunc function, ComponentRef<T>&... refs)
+	: AsyncHeldRefs<T...>(refs...), function(std::move(function)) { }
+
+template<typename TFunc, TypenameDerivedFrom<Component>... T>
+inline bool Background<TFunc, T...>::await_ready() const noexcept {
+	return false;
+}
+
+template<typename TFunc, TypenameDerivedFrom<Component>... T>
+inline void Background<TFunc, T...>::await_suspend(AsyncSystemHandle handle) {
+	this->Hold(handle);
+	AsyncScheduler& scheduler = handle.promise().GetScheduler();
+	// the job is started after suspending, so it can never complete early
+	scheduler.RunJob(handle, [job = std::move(function), state = this->state,
+		inbox = scheduler.GetInbox(), handle]() mutable -> void {
+		try {
+			if constexpr (std::is_void_v<ResultType>) {
+				job();
+				state->result.emplace(true);
+			} else {
+				state->result.emplace(job());
+			}
+		} catch (...) {
+			state->exception = std::current_exception();
+		}
+		if (const std::shared_ptr<AsyncJobInbox> target = inbox.lock()) target->Push(handle);
+	});
+}
+
+template<typename TFunc, TypenameDerivedFrom<Component>... T>
+inline typename Background<TFunc, T...>::ResultType Background<TFunc, T...>::await_resume() {
+	if (state->exception != nullptr) std::rethrow_exception(state->exception);
+	if constexpr (!std::is_void_v<ResultType>) return std::move(*state->result);
+}
+
+// ----------------------------- AsyncSystemPromise ----------------------------
+
+// defined here, AsyncSystem is incomplete in the class body
+inline AsyncSystem AsyncSystemPromise::get_return_object() {
+	return AsyncSystem(AsyncSystemHandle::from_promise(*this));
+}
+
+} // namespace Junia
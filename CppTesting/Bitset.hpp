@@ -0,0 +1,104 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+constexpr size_t BITSET_WORD_BITS = 64;
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A growable set of bits stored in 64 bit words (bits past the end are
+ *        unset), with accessible words for skipping runs of unset bits
+*/
+class Bitset {
+private:
+	std::vector<uint64_t> words{ };
+	size_t setCount = 0;
+
+public:
+	Bitset() = default;
+
+	/**
+	 * @brief Create a bitset from words returned by Bitset::GetWords()
+	 * @param words The words
+	*/
+	explicit Bitset(std::vector<uint64_t> words);
+
+	/**
+	 * @brief Check whether a bit is set
+	 * @param bit The index of the bit
+	 * @return true if the bit is set, false otherwise
+	*/
+	[[nodiscard]] bool Test(size_t bit) const;
+
+	/**
+	 * @brief Set or unset a bit (grows the bitset when setting a bit past the
+	 *        end)
+	 * @param bit The index of the bit
+	 * @param value The new value of the bit
+	*/
+	void Set(size_t bit, bool value);
+
+	/**
+	 * @brief Unset all bits
+	*/
+	void Clear();
+
+	/**
+	 * @brief Check whether any bit is set
+	 * @return true if at least one bit is set, false otherwise
+	*/
+	[[nodiscard]] bool Any() const;
+
+	/**
+	 * @brief Get the underlying words (bit i is bit i % 64 of word i / 64)
+	 * @return A const reference to the words
+	*/
+	[[nodiscard]] const std::vector<uint64_t>& GetWords() const;
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+inline Bitset::Bitset(std::vector<uint64_t> words)
+	: words(std::move(words)) {
+	for (const uint64_t word : this->words) setCount += static_cast<size_t>(std::popcount(word));
+}
+
+inline bool Bitset::Test(size_t bit) const {
+	const size_t word = bit / BITSET_WORD_BITS;
+	return word < words.size() && ((words[word] >> (bit % BITSET_WORD_BITS)) & 1U) != 0;
+}
+
+inline void Bitset::Set(size_t bit, bool value) {
+	if (Test(bit) == value) return;
+	const size_t word = bit / BITSET_WORD_BITS;
+	if (word >= words.size()) words.resize(word + 1);
+	words[word] ^= uint64_t{ 1 } << (bit % BITSET_WORD_BITS);
+	if (value) setCount++;
+	else setCount--;
+}
+
+inline void Bitset::Clear() {
+	words.clear();
+	setCount = 0;
+}
+
+inline bool Bitset::Any() const {
+	return setCount != 0;
+}
+
+inline const std::vector<uint64_t>& Bitset::GetWords() const {
+	return words;
+}
+
+} // namespace Junia
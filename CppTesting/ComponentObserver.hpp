@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ECS.hpp"
+
+#include <memory>
+#include <typeindex>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief INTERNAL USE ONLY - Mirrors the components of one type (e.g. in an
+ *        index). Writes are not reported as they happen: added components
+ *        and components handed out for writing are reported as changed once
+ *        the changes of the type are flushed.
+*/
+class ComponentObserver {
+public:
+	ComponentObserver() = default;
+	virtual ~ComponentObserver() = default;
+	ComponentObserver(const ComponentObserver&) = delete;
+	ComponentObserver(ComponentObserver&&) = delete;
+
+	ComponentObserver& operator=(const ComponentObserver&) = delete;
+	ComponentObserver& operator=(ComponentObserver&&) = delete;
+
+	/**
+	 * @brief A component has been added or may have been written to
+	 * @param component A pointer to the component
+	*/
+	virtual void OnComponentChanged(const void* component) = 0;
+
+	/**
+	 * @brief A component has been removed (also called for entities that did
+	 *        not have the component when they are destroyed)
+	 * @param entity The entity the component has been removed from
+	*/
+	virtual void OnComponentRemoved(EntityIdType entity) = 0;
+
+	/**
+	 * @brief All components are gone (the store has been replaced or loaded,
+	 *        the remaining components are reported as changed afterwards)
+	*/
+	virtual void OnComponentsCleared() = 0;
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Register an observer with the active world (it
+ *        stays registered until it is destroyed)
+ * @param type The component type to observe
+ * @param observer The observer
+*/
+void RegisterComponentObserver(std::type_index type, const std::shared_ptr<ComponentObserver>& observer);
+
+/**
+ * @brief INTERNAL USE ONLY - Report the changed components of a type to its
+ *        observers in the active world
+ * @param type The component type
+*/
+void FlushComponentChanges(std::type_index type);
+
+} // namespace Junia
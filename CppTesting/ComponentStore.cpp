@@ -1,187 +1,1077 @@
-#include "ComponentStore.hpp"
-#include "gsl.hpp"
-
-#include <stdexcept>
-
-namespace Junia {
-
-static void DeleteByteArrayCallback(gsl::owner<const uint8_t*> ptr) {
-	delete[] ptr;
-}
-
-// -----------------------------------------------------------------------------
-// ------------------------------ Static functions -----------------------------
-// -----------------------------------------------------------------------------
-
-ComponentStore::ComponentStoreMapType& ComponentStore::GetComponentStores() {
-	static ComponentStoreMapType componentStores{ };
-	return componentStores;
-}
-
-void ComponentStore::Create(std::type_index type, size_t size, size_t preallocCount,
-	DestructorFunc destructor, CopyConstructorFunc copyConstructor) {
-	GetComponentStores()[type] = std::make_shared<ComponentStore>(size,
-		preallocCount, std::move(destructor), std::move(copyConstructor));
-}
-
-void ComponentStore::Destroy(std::type_index type) {
-	GetComponentStores().erase(type);
-}
-
-std::shared_ptr<ComponentStore> ComponentStore::Get(std::type_index type) {
-	return GetComponentStores().at(type);
-}
-
-void ComponentStore::RemoveAllComponents(EntityIdType entity) {
-	for (auto& componentStorePair : GetComponentStores())
-		componentStorePair.second->RemoveComponent(entity);
-}
-
-// -----------------------------------------------------------------------------
-// ------------------------------ Member functions -----------------------------
-// -----------------------------------------------------------------------------
-
-void ComponentStore::ReallocUpsize() {
-	capacity *= 2;
-	if (capacity == 0) capacity = 2;
-
-	const std::shared_ptr<uint8_t> new_data(
-		new uint8_t[capacity * elementSize], DeleteByteArrayCallback);
-
-	for (ComponentIdType i = 0; i < count; i++) {
-		if (freeComponentIds.contains(i)) continue;
-		void* old_comp = data.get() + (i * elementSize);
-		copyConstructor(new_data.get() + (i * elementSize), old_comp);
-		destructor(old_comp);
-	}
-	data = new_data;
-}
-
-ComponentStore::ComponentStore(size_t size, size_t preallocCount,
-	DestructorFunc destructor, CopyConstructorFunc copyConstructor)
-	: elementSize(size), destructor(std::move(destructor)),
-	copyConstructor(std::move(copyConstructor)),
-	capacity(preallocCount == 0 ? 1 : preallocCount),
-	data(new uint8_t[capacity * elementSize], DeleteByteArrayCallback) { }
-
-ComponentStore::ComponentStore(const ComponentStore& other)
-	: entityToComponentMap(other.entityToComponentMap),
-	freeComponentIds(other.freeComponentIds), elementSize(other.elementSize),
-	destructor(other.destructor), copyConstructor(other.copyConstructor),
-	count(other.count), capacity(other.capacity),
-	data(new uint8_t[capacity * elementSize], DeleteByteArrayCallback) {
-	for (ComponentIdType i = 0; i < count; i++) {
-		if (freeComponentIds.contains(i)) continue;
-		copyConstructor(data.get() + (i * elementSize),
-			other.data.get() + (i * elementSize));
-	}
-}
-
-ComponentStore::ComponentStore(ComponentStore&& other) noexcept
-	: entityToComponentMap(std::move(other.entityToComponentMap)),
-	freeComponentIds(std::move(other.freeComponentIds)),
-	elementSize(other.elementSize), destructor(std::move(other.destructor)),
-	copyConstructor(std::move(other.copyConstructor)), count(other.count),
-	capacity(other.capacity), data(std::move(other.data)) {
-	other.capacity = 0;
-	other.count = 0;
-	other.data = nullptr;
-}
-
-ComponentStore::~ComponentStore() {
-	for (ComponentIdType i = 0; i < count; i++) {
-		if (freeComponentIds.contains(i)) continue;
-		destructor(data.get() + (i * elementSize));
-	}
-}
-
-ComponentStore& ComponentStore::operator=(const ComponentStore& other) {
-	if (&other == this) return *this;
-	if (capacity > 0 && data != nullptr) {
-		for (ComponentIdType i = 0; i < count; i++) {
-			if (freeComponentIds.contains(i)) continue;
-			destructor(data.get() + (i * elementSize));
-		}
-		entityToComponentMap.clear();
-		capacity = 0;
-		count = 0;
-	}
-	entityToComponentMap = other.entityToComponentMap;
-	freeComponentIds = other.freeComponentIds;
-	elementSize = other.elementSize;
-	destructor = other.destructor;
-	copyConstructor = other.copyConstructor;
-	count = other.count;
-	capacity = other.capacity;
-	data = std::shared_ptr<uint8_t>(new uint8_t[capacity * elementSize], DeleteByteArrayCallback);
-	for (ComponentIdType i = 0; i < count; i++) {
-		if (freeComponentIds.contains(i)) continue;
-		copyConstructor(data.get() + (i * elementSize), other.data.get() + (i * elementSize));
-	}
-	return *this;
-}
-
-ComponentStore& ComponentStore::operator=(ComponentStore&& other) noexcept {
-	if (capacity > 0 && data != nullptr) {
-		for (ComponentIdType i = 0; i < count; i++) {
-			if (freeComponentIds.contains(i)) continue;
-			destructor(data.get() + (i * elementSize));
-		}
-		entityToComponentMap.clear();
-		capacity = 0;
-		count = 0;
-	}
-	entityToComponentMap = std::move(other.entityToComponentMap);
-	freeComponentIds = std::move(other.freeComponentIds);
-	elementSize = other.elementSize;
-	destructor = std::move(other.destructor);
-	copyConstructor = std::move(other.copyConstructor);
-	count = other.count;
-	capacity = other.capacity;
-	data = std::move(other.data);
-	other.capacity = 0;
-	other.count = 0;
-	other.data = nullptr;
-	return *this;
-}
-
-void* ComponentStore::AllocateComponent(EntityIdType entity) {
-	if (entityToComponentMap.contains(entity))
-		throw std::runtime_error("entity already has component");
-
-	ComponentIdType newComponentId = count;
-	if (!freeComponentIds.empty()) {
-		auto iterator = freeComponentIds.begin();
-		newComponentId = *iterator;
-		freeComponentIds.erase(iterator);
-	} else {
-		if (capacity < count + 1) ReallocUpsize();
-		count++;
-	}
-	entityToComponentMap[entity] = newComponentId;
-	return data.get() + (newComponentId * elementSize);
-}
-
-void ComponentStore::RemoveComponent(EntityIdType entity) {
-	if (!entityToComponentMap.contains(entity)) return;
-	const ComponentIdType componentId = entityToComponentMap.at(entity);
-	destructor(data.get() + (componentId * elementSize));
-	entityToComponentMap.erase(entity);
-	freeComponentIds.insert(componentId);
-	if (componentId == count - 1) count--;
-}
-
-void* ComponentStore::GetComponent(EntityIdType entity) {
-	const ComponentIdType componentId = entityToComponentMap.at(entity);
-	return data.get() + (componentId * elementSize);
-}
-
-size_t ComponentStore::GetComponentOffset(EntityIdType entity) {
-	return entityToComponentMap.at(entity) * elementSize;
-}
-
-void* ComponentStore::GetComponentByOffset(size_t offset) {
-	return data.get() + offset;
-}
-
-}  // namespace Junia
+#include "ComponentStore.hpp"
+#include "gsl.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief Alignment of raw component data blocks in snapshots
+*/
+constexpr size_t SNAPSHOT_DATA_ALIGNMENT = 64;
+
+/**
+ * @brief Size of a component store page in bytes (pages hold at least one
+ *        component, so larger components get pages of their own size)
+*/
+constexpr size_t STORE_PAGE_SIZE = 16384;
+
+/**
+ * @brief Amount of equal bytes between two changed byte runs of a component
+ *        up to which the runs are merged in deltas (saves the run headers)
+*/
+constexpr size_t DELTA_RUN_MERGE_GAP = 8;
+
+/**
+ * @brief Size of the vtable pointer every component starts with (specific to
+ *        the process, so it is never part of the changed bytes in deltas)
+*/
+constexpr size_t VTABLE_POINTER_SIZE = sizeof(void*);
+
+/**
+ * @brief Deleter of pages that point into a mapped snapshot (keeps the mapping
+ *        alive). The components on these pages have never been constructed,
+ *        so they are copied to a page of their own before being written to and
+ *        are never destroyed.
+*/
+struct MappedPageDeleter {
+	std::shared_ptr<uint8_t> mapping;
+
+	void operator()(const uint8_t*) const { }
+};
+
+/**
+ * @brief Check whether a page points into a mapped snapshot
+ * @param page The page to check
+ * @return Whether the page has been created by ComponentStore::Load()
+*/
+static bool IsMappedPage(const std::shared_ptr<uint8_t>& page) {
+	return std::get_deleter<MappedPageDeleter>(page) != nullptr;
+}
+
+/**
+ * @brief The metadata of a component store as written to a snapshot
+*/
+struct StoreSnapshotHeader {
+	uint64_t elementSize = 0;
+	uint64_t componentsPerPage = 1;
+	uint64_t count = 0;
+	bool bitwise = false;
+	std::vector<uint64_t> freeIds{ };
+	std::vector<EntityIdType> entities{ };
+	std::vector<uint64_t> componentIds{ };
+	std::vector<uint64_t> disabledSlots{ };
+};
+
+static void DeleteByteArrayCallback(gsl::owner<const uint8_t*> ptr) {
+	delete[] ptr;
+}
+
+static StoreSnapshotHeader ReadStoreHeader(BinaryReader& reader) {
+	StoreSnapshotHeader header{ };
+	header.elementSize = reader.Read<uint64_t>();
+	header.componentsPerPage = reader.Read<uint64_t>();
+	header.count = reader.Read<uint64_t>();
+	header.bitwise = reader.Read<uint8_t>() != 0;
+	header.freeIds = reader.ReadVector<uint64_t>();
+	header.entities = reader.ReadVector<EntityIdType>();
+	header.componentIds = reader.ReadVector<uint64_t>();
+	header.disabledSlots = reader.ReadVector<uint64_t>();
+	if (header.entities.size() != header.componentIds.size())
+		throw std::runtime_error("corrupted snapshot entity table");
+	for (const uint64_t componentId : header.componentIds) {
+		if (componentId >= header.count)
+			throw std::runtime_error("corrupted snapshot entity table");
+	}
+	for (const uint64_t freeId : header.freeIds) {
+		if (freeId >= header.count)
+			throw std::runtime_error("corrupted snapshot entity table");
+	}
+	// every slot is either live or free, which bounds the data block by the
+	// size of the tables that have actually been read
+	if (header.entities.size() + header.freeIds.size() != header.count)
+		throw std::runtime_error("corrupted snapshot entity table");
+	if (header.elementSize == 0 || header.componentsPerPage == 0
+		|| header.componentsPerPage > std::max<uint64_t>(1, STORE_PAGE_SIZE / header.elementSize))
+		throw std::runtime_error("corrupted snapshot store header");
+	return header;
+}
+
+/**
+ * @brief Get the size of the raw data block of a store in a snapshot
+ * @param header The header of the store
+ * @return The size in bytes (whole pages)
+*/
+static uint64_t GetDataBlockSize(const StoreSnapshotHeader& header) {
+	const uint64_t usedPages = (header.count + header.componentsPerPage - 1) / header.componentsPerPage;
+	return usedPages * header.componentsPerPage * header.elementSize;
+}
+
+/**
+ * @brief Write the ranges in which two components differ
+ * @param writer The writer to write the amount of runs followed by
+ *               (offset, length, bytes) for each run to
+ * @param baseline The old component bytes
+ * @param current The new component bytes
+ * @param size The size of the component in bytes
+*/
+static void WriteChangedRuns(BinaryWriter& writer, const uint8_t* baseline,
+	const uint8_t* current, size_t size) {
+	std::vector<std::pair<size_t, size_t>> runs{ };
+	size_t offset = VTABLE_POINTER_SIZE;
+	while (offset < size) {
+		if (baseline[offset] == current[offset]) {
+			offset++;
+			continue;
+		}
+		const size_t start = offset;
+		size_t end = offset + 1;
+		for (size_t i = end; i < size && i - end < DELTA_RUN_MERGE_GAP; i++) {
+			if (baseline[i] != current[i]) end = i + 1;
+		}
+		runs.emplace_back(start, end - start);
+		offset = end;
+	}
+
+	writer.Write<uint32_t>(static_cast<uint32_t>(runs.size()));
+	for (const auto& run : runs) {
+		writer.Write<uint32_t>(static_cast<uint32_t>(run.first));
+		writer.Write<uint32_t>(static_cast<uint32_t>(run.second));
+		writer.WriteBytes(current + run.first, run.second);
+	}
+}
+
+/**
+ * @brief Estimate the memory used by a node based hash container
+ * @param container The container
+ * @return The bucket array plus one node (value, next pointer and cached hash)
+ *         per element in bytes
+*/
+template<typename T>
+static size_t EstimateHashContainerBytes(const T& container) {
+	return (container.bucket_count() * sizeof(void*))
+		+ (container.size() * (sizeof(typename T::value_type) + (2 * sizeof(void*))));
+}
+
+#ifdef JUNIA_ECS_STATS
+static void CountCalls(std::atomic<uint64_t>& counter, uint64_t calls = 1) {
+	counter.fetch_add(calls, std::memory_order_relaxed);
+}
+#endif
+
+static std::unordered_map<std::string, std::shared_ptr<ComponentStore>> GetStoresByName(
+	const std::unordered_map<std::type_index, std::shared_ptr<ComponentStore>>& stores) {
+	std::unordered_map<std::string, std::shared_ptr<ComponentStore>> storesByName{ };
+	for (const auto& componentStorePair : stores)
+		storesByName[componentStorePair.first.name()] = componentStorePair.second;
+	return storesByName;
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Static functions -----------------------------
+// -----------------------------------------------------------------------------
+
+ComponentStore::ComponentStoreMapType& ComponentStore::GetComponentStores() {
+	return World::GetActiveWorld().GetComponentStores();
+}
+
+void ComponentStore::Create(std::type_index type, size_t size, size_t preallocCount,
+	DestructorFunc destructor, CopyConstructorFunc copyConstructor) {
+	GetComponentStores()[type] = std::make_shared<ComponentStore>(size,
+		preallocCount, std::move(destructor), std::move(copyConstructor));
+}
+
+void ComponentStore::Destroy(std::type_index type) {
+	GetComponentStores().erase(type);
+}
+
+std::shared_ptr<ComponentStore> ComponentStore::Get(std::type_index type) {
+	return GetComponentStores().at(type);
+}
+
+void ComponentStore::RemoveAllComponents(EntityIdType entity) {
+	for (auto& componentStorePair : GetComponentStores())
+		componentStorePair.second->RemoveComponent(entity);
+}
+
+void ComponentStore::CheckAllSnapshottable() {
+	for (auto& componentStorePair : GetComponentStores()) {
+		if (!componentStorePair.second->IsSnapshottable()) {
+			throw std::runtime_error("component type " + std::string(componentStorePair.first.name())
+				+ " has neither serialization hooks nor a raw snapshot opt-in");
+		}
+	}
+}
+
+void ComponentStore::SaveAll(BinaryWriter& writer) {
+	writer.Write<uint64_t>(GetComponentStores().size());
+	for (auto& componentStorePair : GetComponentStores()) {
+		writer.WriteString(componentStorePair.first.name());
+		componentStorePair.second->Save(writer);
+	}
+}
+
+void ComponentStore::LoadAll(BinaryReader& reader, const MappedFile* mappedFile) {
+	auto storesByName = GetStoresByName(GetComponentStores());
+
+	// the stores are loaded into copies (sharing their pages) that only
+	// replace them once all of them have been read
+	std::vector<std::pair<std::shared_ptr<ComponentStore>, ComponentStore>> loaded{ };
+	const auto storeCount = reader.Read<uint64_t>();
+	for (uint64_t i = 0; i < storeCount; i++) {
+		const std::string name = reader.ReadString();
+		auto iterator = storesByName.find(name);
+		if (iterator == storesByName.end())
+			throw std::runtime_error("snapshot contains unregistered component type " + name);
+		loaded.emplace_back(iterator->second, ComponentStore(*iterator->second));
+		loaded.back().second.Load(reader, mappedFile);
+		storesByName.erase(iterator);
+	}
+
+	for (auto& loadedPair : loaded) {
+		// observers receive every loaded component as changed
+		loadedPair.second.SetChangeTracking(loadedPair.first->trackChanges);
+		*loadedPair.first = std::move(loadedPair.second);
+	}
+	for (auto& componentStorePair : storesByName)
+		componentStorePair.second->Clear();
+}
+
+void ComponentStore::WriteDeltaAll(BinaryReader& baseline, BinaryWriter& writer) {
+	auto storesByName = GetStoresByName(GetComponentStores());
+	writer.Write<uint64_t>(storesByName.size());
+
+	const auto storeCount = baseline.Read<uint64_t>();
+	for (uint64_t i = 0; i < storeCount; i++) {
+		const std::string name = baseline.ReadString();
+		auto iterator = storesByName.find(name);
+		if (iterator == storesByName.end())
+			throw std::runtime_error("snapshot contains unregistered component type " + name);
+		writer.WriteString(name);
+		iterator->second->WriteDelta(&baseline, writer);
+		storesByName.erase(iterator);
+	}
+
+	for (auto& componentStorePair : storesByName) {
+		writer.WriteString(componentStorePair.first);
+		componentStorePair.second->WriteDelta(nullptr, writer);
+	}
+}
+
+void ComponentStore::ApplyDeltaAll(BinaryReader& reader) {
+	const auto storesByName = GetStoresByName(GetComponentStores());
+
+	// applied to copies of the stores like in LoadAll(), only the pages
+	// touched by the delta are copied
+	std::vector<std::pair<std::shared_ptr<ComponentStore>, ComponentStore>> applied{ };
+	const auto storeCount = reader.Read<uint64_t>();
+	for (uint64_t i = 0; i < storeCount; i++) {
+		const std::string name = reader.ReadString();
+		auto iterator = storesByName.find(name);
+		if (iterator == storesByName.end())
+			throw std::runtime_error("delta contains unregistered component type " + name);
+		applied.emplace_back(iterator->second, ComponentStore(*iterator->second));
+		applied.back().second.trackChanges = iterator->second->trackChanges;
+		applied.back().second.changedSlots = iterator->second->changedSlots;
+		applied.back().second.changedFlags = iterator->second->changedFlags;
+		applied.back().second.ApplyDelta(reader);
+	}
+
+	for (auto& appliedPair : applied) *appliedPair.first = std::move(appliedPair.second);
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+std::shared_ptr<uint8_t> ComponentStore::AllocatePage() const {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.pageAllocations);
+#endif
+	return std::shared_ptr<uint8_t>(
+		new uint8_t[componentsPerPage * elementSize], DeleteByteArrayCallback);
+}
+
+void ComponentStore::MakePageUnique(size_t page) {
+	if (pages[page].use_count() <= 1 && !IsMappedPage(pages[page])) return;
+
+	// the shared page keeps its components alive for the other stores, this
+	// store continues on a private copy (mapped pages are always copied, the
+	// copy constructor brings the components to life)
+	const std::shared_ptr<uint8_t> copy = AllocatePage();
+	const ComponentIdType first = page * componentsPerPage;
+	const ComponentIdType last = std::min(count, first + componentsPerPage);
+	for (ComponentIdType i = first; i < last; i++) {
+		if (index->freeComponentIds.contains(i)) continue;
+		const size_t offset = (i - first) * elementSize;
+		copyConstructor(copy.get() + offset, pages[page].get() + offset);
+	}
+	pages[page] = copy;
+}
+
+void ComponentStore::ReleasePage(size_t page) {
+	if (pages[page].use_count() > 1 || IsMappedPage(pages[page])) return;
+	const ComponentIdType first = page * componentsPerPage;
+	const ComponentIdType last = std::min(count, first + componentsPerPage);
+	for (ComponentIdType i = first; i < last; i++) {
+		if (index->freeComponentIds.contains(i)) continue;
+		destructor(pages[page].get() + ((i - first) * elementSize));
+	}
+}
+
+void ComponentStore::ReleasePages() {
+	for (size_t page = 0; page < pages.size(); page++) ReleasePage(page);
+	pages.clear();
+}
+
+ComponentStore::ComponentIndex& ComponentStore::GetMutableIndex() {
+	if (index.use_count() > 1) index = std::make_shared<ComponentIndex>(*index);
+	return *index;
+}
+
+uint8_t* ComponentStore::GetSlot(ComponentIdType componentId) const {
+	return pages[componentId / componentsPerPage].get()
+		+ ((componentId % componentsPerPage) * elementSize);
+}
+
+uint8_t* ComponentStore::GetMutableSlot(ComponentIdType componentId) {
+	const size_t page = componentId / componentsPerPage;
+	MakePageUnique(page);
+	if (readBuffer != nullptr) MarkPageDirty(page);
+	if (trackChanges) MarkChanged(componentId);
+	return GetSlot(componentId);
+}
+
+void ComponentStore::MarkChanged(ComponentIdType componentId) {
+	const std::lock_guard<std::mutex> lock(changesMutex);
+	if (changedFlags.size() <= componentId) changedFlags.resize(pages.size() * componentsPerPage);
+	if (changedFlags[componentId]) return;
+	changedFlags[componentId] = true;
+	changedSlots.push_back(componentId);
+}
+
+void ComponentStore::MarkPageDirty(size_t page) {
+	// pages added since the last frame boundary are new to the read buffer
+	if (page >= dirtyPages.size()) return;
+	std::atomic_ref<uint8_t> dirty(dirtyPages[page]);
+	if (dirty.load(std::memory_order_relaxed) == 0) dirty.store(1, std::memory_order_relaxed);
+}
+
+void ComponentStore::RecordMove(EntityIdType entity, ComponentIdType componentId) {
+	if (readBuffer == nullptr) return;
+	movedEntities.push_back(entity);
+	movedSlots.push_back(componentId);
+}
+
+void ComponentStore::RebuildReadBuffer() {
+	dirtyPages.assign(pages.size(), 0);
+	movedEntities.clear();
+	movedSlots.clear();
+	rebuildReadBuffer = false;
+
+	// the read buffer gets all pages and its own index, the store copies the
+	// pages right away so that writers never have to copy a shared page
+	readBuffer.reset();
+	auto buffer = std::make_shared<ComponentStore>(*this);
+	buffer->index = std::make_shared<ComponentIndex>(*index);
+	readBuffer = std::move(buffer);
+	for (size_t page = 0; page < pages.size(); page++) MakePageUnique(page);
+}
+
+void ComponentStore::UpdateReadBuffer() {
+	// a read buffer shared with a fork is left to the fork
+	if (rebuildReadBuffer || readBuffer.use_count() > 1) {
+		RebuildReadBuffer();
+		return;
+	}
+
+	// the pages written since the last frame boundary move to the read buffer
+	// (its old copies are released while they still match its index), the
+	// store continues on copies of them
+	ComponentStore& buffer = *readBuffer;
+	for (size_t page = 0; page < dirtyPages.size(); page++) {
+		if (dirtyPages[page] == 0) continue;
+		buffer.ReleasePage(page);
+		buffer.pages[page] = pages[page];
+		MakePageUnique(page);
+	}
+	for (size_t page = buffer.pages.size(); page < pages.size(); page++) {
+		buffer.pages.push_back(pages[page]);
+		MakePageUnique(page);
+	}
+
+	// only the entries of the entities and slots that moved are updated
+	ComponentIndex& bufferIndex = buffer.GetMutableIndex();
+	for (const EntityIdType entity : movedEntities) {
+		auto iterator = index->entityToComponentMap.find(entity);
+		if (iterator == index->entityToComponentMap.end()) bufferIndex.entityToComponentMap.erase(entity);
+		else bufferIndex.entityToComponentMap[entity] = iterator->second;
+	}
+	for (const ComponentIdType componentId : movedSlots) {
+		if (index->freeComponentIds.contains(componentId)) bufferIndex.freeComponentIds.insert(componentId);
+		else bufferIndex.freeComponentIds.erase(componentId);
+	}
+	buffer.count = count;
+
+	dirtyPages.assign(pages.size(), 0);
+	movedEntities.clear();
+	movedSlots.clear();
+}
+
+bool ComponentStore::IsLive(ComponentIdType componentId) const {
+	return componentId < count && !index->freeComponentIds.contains(componentId);
+}
+
+bool ComponentStore::HasValidVtables(uint8_t* data) const {
+	ComponentIdType first = 0;
+	while (first < count && index->freeComponentIds.contains(first)) first++;
+	if (first == count) return true;
+
+	// a copy constructed component has the vtable pointer of this process,
+	// which the mapped components share if the executable image has been
+	// loaded to the same address (the same process, a forked process or a
+	// build without address space layout randomization)
+	uint8_t* component = data + (first * elementSize);
+	const std::unique_ptr<uint8_t[]> copy(new uint8_t[elementSize]);
+	copyConstructor(copy.get(), component);
+	const bool valid = std::memcmp(copy.get(), component, VTABLE_POINTER_SIZE) == 0;
+	destructor(copy.get());
+	return valid;
+}
+
+bool ComponentStore::MatchesSnapshotMode(bool bitwise) const {
+	return bitwise ? rawSnapshot && !serialize : static_cast<bool>(serialize);
+}
+
+ComponentStore::ComponentStore(size_t size, size_t preallocCount,
+	DestructorFunc destructor, CopyConstructorFunc copyConstructor)
+	: index(std::make_shared<ComponentIndex>()), elementSize(size),
+	componentsPerPage(std::max<size_t>(1, STORE_PAGE_SIZE / size)),
+	destructor(std::move(destructor)), copyConstructor(std::move(copyConstructor)) {
+	do pages.push_back(AllocatePage());
+	while (pages.size() * componentsPerPage < preallocCount);
+}
+
+ComponentStore::ComponentStore(const ComponentStore& other)
+	: index(other.index), elementSize(other.elementSize),
+	componentsPerPage(other.componentsPerPage), destructor(other.destructor),
+	copyConstructor(other.copyConstructor), serialize(other.serialize),
+	deserialize(other.deserialize), rawSnapshot(other.rawSnapshot),
+	count(other.count), pages(other.pages),
+	disabledSlots(other.disabledSlots), readBuffer(other.readBuffer),
+	dirtyPages(other.dirtyPages), movedEntities(other.movedEntities),
+	movedSlots(other.movedSlots), rebuildReadBuffer(other.rebuildReadBuffer) { }
+
+ComponentStore::ComponentStore(ComponentStore&& other) noexcept
+	: index(std::move(other.index)), elementSize(other.elementSize),
+	componentsPerPage(other.componentsPerPage),
+	destructor(std::move(other.destructor)),
+	copyConstructor(std::move(other.copyConstructor)),
+	serialize(std::move(other.serialize)),
+	deserialize(std::move(other.deserialize)), rawSnapshot(other.rawSnapshot),
+	count(other.count),
+	pages(std::move(other.pages)), disabledSlots(std::move(other.disabledSlots)),
+	trackChanges(other.trackChanges),
+	changedSlots(std::move(other.changedSlots)),
+	changedFlags(std::move(other.changedFlags)),
+	readBuffer(std::move(other.readBuffer)),
+	dirtyPages(std::move(other.dirtyPages)),
+	movedEntities(std::move(other.movedEntities)),
+	movedSlots(std::move(other.movedSlots)),
+	rebuildReadBuffer(other.rebuildReadBuffer) {
+	other.index = std::make_shared<ComponentIndex>();
+	other.count = 0;
+	other.pages.clear();
+	other.disabledSlots.Clear();
+}
+
+ComponentStore::~ComponentStore() {
+	ReleasePages();
+}
+
+ComponentStore& ComponentStore::operator=(const ComponentStore& other) {
+	if (&other == this) return *this;
+	ReleasePages();
+	index = other.index;
+	elementSize = other.elementSize;
+	componentsPerPage = other.componentsPerPage;
+	destructor = other.destructor;
+	copyConstructor = other.copyConstructor;
+	serialize = other.serialize;
+	deserialize = other.deserialize;
+	rawSnapshot = other.rawSnapshot;
+	count = other.count;
+	pages = other.pages;
+	disabledSlots = other.disabledSlots;
+	readBuffer = other.readBuffer;
+	dirtyPages = other.dirtyPages;
+	movedEntities = other.movedEntities;
+	movedSlots = other.movedSlots;
+	rebuildReadBuffer = other.rebuildReadBuffer;
+	SetChangeTracking(trackChanges);
+	return *this;
+}
+
+ComponentStore& ComponentStore::operator=(ComponentStore&& other) noexcept {
+	if (&other == this) return *this;
+	ReleasePages();
+	index = std::move(other.index);
+	elementSize = other.elementSize;
+	componentsPerPage = other.componentsPerPage;
+	destructor = std::move(other.destructor);
+	copyConstructor = std::move(other.copyConstructor);
+	serialize = std::move(other.serialize);
+	deserialize = std::move(other.deserialize);
+	rawSnapshot = other.rawSnapshot;
+	count = other.count;
+	pages = std::move(other.pages);
+	disabledSlots = std::move(other.disabledSlots);
+	trackChanges = other.trackChanges;
+	changedSlots = std::move(other.changedSlots);
+	changedFlags = std::move(other.changedFlags);
+	readBuffer = std::move(other.readBuffer);
+	dirtyPages = std::move(other.dirtyPages);
+	movedEntities = std::move(other.movedEntities);
+	movedSlots = std::move(other.movedSlots);
+	rebuildReadBuffer = other.rebuildReadBuffer;
+	other.index = std::make_shared<ComponentIndex>();
+	other.count = 0;
+	other.pages.clear();
+	other.disabledSlots.Clear();
+	return *this;
+}
+
+void* ComponentStore::AllocateComponent(EntityIdType entity) {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.addCalls);
+#endif
+	if (index->entityToComponentMap.contains(entity))
+		throw std::runtime_error("entity already has component");
+
+	ComponentIndex& mutableIndex = GetMutableIndex();
+	ComponentIdType newComponentId = count;
+	if (!mutableIndex.freeComponentIds.empty()) {
+		auto iterator = mutableIndex.freeComponentIds.begin();
+		newComponentId = *iterator;
+		// copy a shared page while the slot is still marked as free
+		MakePageUnique(newComponentId / componentsPerPage);
+		mutableIndex.freeComponentIds.erase(iterator);
+	} else {
+		if (pages.size() * componentsPerPage < count + 1) pages.push_back(AllocatePage());
+		else MakePageUnique(count / componentsPerPage);
+		count++;
+	}
+	mutableIndex.entityToComponentMap[entity] = newComponentId;
+	RecordMove(entity, newComponentId);
+	return GetMutableSlot(newComponentId);
+}
+
+void ComponentStore::AllocateComponents(const std::vector<EntityIdType>& entities,
+	const BatchConstructorFunc& construct) {
+	if (entities.empty()) return;
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.addCalls, entities.size());
+#endif
+
+	std::vector<EntityIdType> sortedEntities = entities;
+	std::ranges::sort(sortedEntities);
+	if (std::ranges::adjacent_find(sortedEntities) != sortedEntities.end())
+		throw std::runtime_error("entity already has component");
+	for (const EntityIdType entity : entities) {
+		if (index->entityToComponentMap.contains(entity))
+			throw std::runtime_error("entity already has component");
+	}
+
+	// the lowest holes are filled first (so that they form runs), the rest of
+	// the components is appended
+	std::vector<ComponentIdType> slots(index->freeComponentIds.begin(), index->freeComponentIds.end());
+	const size_t reused = std::min(slots.size(), entities.size());
+	std::ranges::partial_sort(slots, slots.begin() + static_cast<std::ptrdiff_t>(reused));
+	slots.resize(reused);
+	for (ComponentIdType componentId = count; slots.size() < entities.size(); componentId++)
+		slots.push_back(componentId);
+	const ComponentIdType newCount = std::max<ComponentIdType>(count, slots.back() + 1);
+
+	// (first index into slots, length) of every run of consecutive slots on
+	// the same page
+	std::vector<std::pair<size_t, size_t>> runs{ };
+	for (size_t i = 0; i < slots.size(); i++) {
+		if (i > 0 && slots[i] == slots[i - 1] + 1 && slots[i] % componentsPerPage != 0) runs.back().second++;
+		else runs.emplace_back(i, 1);
+	}
+
+	// shared pages are copied while the slots are still free
+	for (const auto& [first, length] : runs) {
+		const size_t page = slots[first] / componentsPerPage;
+		if (page < pages.size()) MakePageUnique(page);
+	}
+	while (pages.size() * componentsPerPage < newCount)
+		pages.push_back(AllocatePage());
+
+	// the components only become part of the store once all of them are
+	// constructed, the runs before a failing one are destroyed again
+	size_t constructed = 0;
+	try {
+		for (const auto& [first, length] : runs) {
+			construct(GetSlot(slots[first]), length, entities.data() + first);
+			constructed = first + length;
+		}
+	} catch (...) {
+		for (size_t i = 0; i < constructed; i++) destructor(GetSlot(slots[i]));
+		throw;
+	}
+
+	ComponentIndex& mutableIndex = GetMutableIndex();
+	for (size_t i = 0; i < entities.size(); i++) {
+		mutableIndex.entityToComponentMap.emplace(entities[i], slots[i]);
+		RecordMove(entities[i], slots[i]);
+	}
+	for (size_t i = 0; i < reused; i++) mutableIndex.freeComponentIds.erase(slots[i]);
+	count = newCount;
+
+	if (readBuffer != nullptr) {
+		for (const auto& [first, length] : runs) MarkPageDirty(slots[first] / componentsPerPage);
+	}
+	if (trackChanges) {
+		for (const ComponentIdType componentId : slots) MarkChanged(componentId);
+	}
+}
+
+void ComponentStore::RemoveComponent(EntityIdType entity) {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.removeCalls);
+#endif
+	auto iterator = index->entityToComponentMap.find(entity);
+	if (iterator == index->entityToComponentMap.end()) return;
+	const ComponentIdType componentId = iterator->second;
+	destructor(GetMutableSlot(componentId));
+	ComponentIndex& mutableIndex = GetMutableIndex();
+	mutableIndex.entityToComponentMap.erase(entity);
+	RecordMove(entity, componentId);
+	disabledSlots.Set(componentId, false);
+	if (componentId == count - 1) count--;
+	else mutableIndex.freeComponentIds.insert(componentId);
+}
+
+bool ComponentStore::HasComponent(EntityIdType entity) const {
+	return index->entityToComponentMap.contains(entity);
+}
+
+void* ComponentStore::GetComponent(EntityIdType entity) {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.getCalls);
+#endif
+	return GetMutableSlot(index->entityToComponentMap.at(entity));
+}
+
+const void* ComponentStore::ReadComponent(EntityIdType entity) const {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.getCalls);
+#endif
+	if (readBuffer != nullptr) {
+		// components added since the last frame boundary are read as they are
+		auto iterator = readBuffer->index->entityToComponentMap.find(entity);
+		if (iterator != readBuffer->index->entityToComponentMap.end())
+			return readBuffer->GetSlot(iterator->second);
+	}
+	return GetSlot(index->entityToComponentMap.at(entity));
+}
+
+void ComponentStore::SetEnabled(EntityIdType entity, bool enabled) {
+	disabledSlots.Set(index->entityToComponentMap.at(entity), !enabled);
+}
+
+bool ComponentStore::IsEnabled(EntityIdType entity) const {
+	return !disabledSlots.Test(index->entityToComponentMap.at(entity));
+}
+
+bool ComponentStore::HasDisabled() const {
+	return disabledSlots.Any();
+}
+
+size_t ComponentStore::GetCount() const {
+	return index->entityToComponentMap.size();
+}
+
+std::vector<EntityIdType> ComponentStore::GetEntities() const {
+	std::vector<EntityIdType> entities{ };
+	entities.reserve(index->entityToComponentMap.size());
+	for (const auto& entityComponentPair : index->entityToComponentMap)
+		entities.push_back(entityComponentPair.first);
+	return entities;
+}
+
+size_t ComponentStore::GetComponentOffset(EntityIdType entity) {
+	return index->entityToComponentMap.at(entity) * elementSize;
+}
+
+void* ComponentStore::GetComponentByOffset(size_t offset) {
+#ifdef JUNIA_ECS_STATS
+	CountCalls(counters.getCalls);
+#endif
+	return GetMutableSlot(offset / elementSize);
+}
+
+void ComponentStore::SetSerializer(SerializeFunc serializeFunc,
+	DeserializeFunc deserializeFunc) {
+	serialize = std::move(serializeFunc);
+	deserialize = std::move(deserializeFunc);
+}
+
+void ComponentStore::SetRawSnapshot() {
+	rawSnapshot = true;
+}
+
+bool ComponentStore::IsSnapshottable() const {
+	return serialize || rawSnapshot;
+}
+
+void ComponentStore::Clear() {
+	ReleasePages();
+	index = std::make_shared<ComponentIndex>();
+	count = 0;
+	pages.push_back(AllocatePage());
+	disabledSlots.Clear();
+	rebuildReadBuffer = true;
+}
+
+void ComponentStore::Save(BinaryWriter& writer) {
+	const bool bitwise = !serialize;
+	writer.Write<uint64_t>(elementSize);
+	writer.Write<uint64_t>(componentsPerPage);
+	writer.Write<uint64_t>(count);
+	writer.Write<uint8_t>(bitwise ? 1 : 0);
+
+	writer.WriteVector(std::vector<uint64_t>(
+		index->freeComponentIds.begin(), index->freeComponentIds.end()));
+	std::vector<EntityIdType> entities{ };
+	std::vector<uint64_t> componentIds{ };
+	entities.reserve(index->entityToComponentMap.size());
+	componentIds.reserve(index->entityToComponentMap.size());
+	for (const auto& entityComponentPair : index->entityToComponentMap) {
+		entities.push_back(entityComponentPair.first);
+		componentIds.push_back(entityComponentPair.second);
+	}
+	writer.WriteVector(entities);
+	writer.WriteVector(componentIds);
+	writer.WriteVector(disabledSlots.GetWords());
+
+	if (bitwise) {
+		// whole pages are written so that a mapped snapshot can be used page
+		// by page without running over the end of the block
+		const size_t pageSize = componentsPerPage * elementSize;
+		const size_t usedPages = (count + componentsPerPage - 1) / componentsPerPage;
+		writer.Align(SNAPSHOT_DATA_ALIGNMENT);
+		for (size_t page = 0; page < usedPages; page++)
+			writer.WriteBytes(pages[page].get(), pageSize);
+		return;
+	}
+
+	std::ostringstream buffer{ };
+	for (ComponentIdType i = 0; i < count; i++) {
+		if (index->freeComponentIds.contains(i)) continue;
+		buffer.str({ });
+		serialize(buffer, GetSlot(i));
+		writer.WriteString(buffer.str());
+	}
+}
+
+void ComponentStore::Load(BinaryReader& reader, const MappedFile* mappedFile) {
+	const StoreSnapshotHeader header = ReadStoreHeader(reader);
+	if (header.elementSize != elementSize)
+		throw std::runtime_error("snapshot component size does not match registered type");
+	if (!MatchesSnapshotMode(header.bitwise))
+		throw std::runtime_error("snapshot serialization mode does not match registered type");
+
+	ReleasePages();
+	index = std::make_shared<ComponentIndex>();
+	rebuildReadBuffer = true;
+	count = header.count;
+	index->freeComponentIds.insert(header.freeIds.begin(), header.freeIds.end());
+	index->entityToComponentMap.reserve(header.entities.size());
+	for (size_t i = 0; i < header.entities.size(); i++)
+		index->entityToComponentMap[header.entities[i]] = header.componentIds[i];
+	disabledSlots = Bitset(header.disabledSlots);
+
+	const size_t usedPages = (count + componentsPerPage - 1) / componentsPerPage;
+	if (header.bitwise && mappedFile != nullptr && header.componentsPerPage == componentsPerPage) {
+		reader.Align(SNAPSHOT_DATA_ALIGNMENT);
+		// nothing in the block may be looked at before it is known to lie
+		// within the mapping
+		if (GetDataBlockSize(header) > mappedFile->size - reader.GetPosition())
+			throw std::runtime_error("unexpected end of stream");
+		const std::shared_ptr<uint8_t>& mapping = mappedFile->data;
+		if (HasValidVtables(mapping.get() + reader.GetPosition())) {
+			// the pages are used in place, every page gets its own control
+			// block (so copy-on-write between stores still works) that keeps
+			// the mapping alive
+			for (size_t page = 0; page < usedPages; page++) {
+				pages.emplace_back(mapping.get() + reader.GetPosition(), MappedPageDeleter{ mapping });
+				reader.Skip(componentsPerPage * elementSize);
+			}
+			if (pages.empty()) pages.push_back(AllocatePage());
+			return;
+		}
+	}
+
+	do pages.push_back(AllocatePage());
+	while (pages.size() < usedPages);
+
+	// count only covers the slots constructed so far, so a load failing half
+	// way only destroys those
+	count = 0;
+	if (header.bitwise) {
+		// the raw bytes are revived through the copy constructor so that
+		// process specific state (e.g. the vtable pointer) is valid again
+		reader.Align(SNAPSHOT_DATA_ALIGNMENT);
+		std::vector<uint8_t> staging(GetDataBlockSize(header));
+		reader.ReadBytes(staging.data(), staging.size());
+		for (ComponentIdType i = 0; i < header.count; i++) {
+			if (!index->freeComponentIds.contains(i))
+				copyConstructor(GetSlot(i), staging.data() + (i * elementSize));
+			count = i + 1;
+		}
+		return;
+	}
+
+	// the hooks construct the components, which need to know their entity
+	std::vector<EntityIdType> slotEntities(header.count);
+	for (size_t i = 0; i < header.entities.size(); i++) slotEntities[header.componentIds[i]] = header.entities[i];
+	for (ComponentIdType i = 0; i < header.count; i++) {
+		if (!index->freeComponentIds.contains(i)) {
+			std::istringstream buffer(reader.ReadString());
+			deserialize(buffer, GetSlot(i), slotEntities[i]);
+		}
+		count = i + 1;
+	}
+}
+
+void ComponentStore::WriteDelta(BinaryReader* baseline, BinaryWriter& writer) {
+	StoreSnapshotHeader header{ };
+	header.bitwise = !serialize;
+	header.elementSize = elementSize;
+	header.componentsPerPage = componentsPerPage;
+	if (baseline != nullptr) header = ReadStoreHeader(*baseline);
+	if (header.elementSize != elementSize)
+		throw std::runtime_error("snapshot component size does not match registered type");
+	if (!MatchesSnapshotMode(header.bitwise))
+		throw std::runtime_error("snapshot serialization mode does not match registered type");
+
+	// bring the baseline components into a form that can be compared by slot
+	const std::unordered_set<uint64_t> baselineFreeIds(header.freeIds.begin(), header.freeIds.end());
+	std::vector<uint8_t> baselineData{ };
+	std::vector<std::string> baselineRecords{ };
+	if (baseline != nullptr && header.bitwise) {
+		baseline->Align(SNAPSHOT_DATA_ALIGNMENT);
+		baselineData.resize(GetDataBlockSize(header));
+		baseline->ReadBytes(baselineData.data(), baselineData.size());
+	} else if (baseline != nullptr) {
+		baselineRecords.resize(header.count);
+		for (uint64_t i = 0; i < header.count; i++) {
+			if (baselineFreeIds.contains(i)) continue;
+			baselineRecords[i] = baseline->ReadString();
+		}
+	}
+
+	std::unordered_map<EntityIdType, uint64_t> baselineComponents{ };
+	baselineComponents.reserve(header.entities.size());
+	for (size_t i = 0; i < header.entities.size(); i++)
+		baselineComponents[header.entities[i]] = header.componentIds[i];
+
+	std::vector<EntityIdType> removed{ };
+	for (const auto& entityComponentPair : baselineComponents) {
+		if (!index->entityToComponentMap.contains(entityComponentPair.first))
+			removed.push_back(entityComponentPair.first);
+	}
+	writer.WriteVector(removed);
+
+	std::vector<EntityIdType> added{ };
+	std::ostringstream changedBuffer{ };
+	BinaryWriter changedWriter(changedBuffer);
+	uint64_t changedCount = 0;
+	std::ostringstream record{ };
+	for (const auto& entityComponentPair : index->entityToComponentMap) {
+		auto iterator = baselineComponents.find(entityComponentPair.first);
+		if (iterator == baselineComponents.end()) {
+			added.push_back(entityComponentPair.first);
+			continue;
+		}
+
+		const uint8_t* component = GetSlot(entityComponentPair.second);
+		if (header.bitwise) {
+			const uint8_t* baselineComponent = baselineData.data() + (iterator->second * elementSize);
+			if (std::memcmp(component + VTABLE_POINTER_SIZE, baselineComponent + VTABLE_POINTER_SIZE,
+				elementSize - VTABLE_POINTER_SIZE) == 0) continue;
+			changedWriter.Write(entityComponentPair.first);
+			WriteChangedRuns(changedWriter, baselineComponent, component, elementSize);
+		} else {
+			record.str({ });
+			serialize(record, GetSlot(entityComponentPair.second));
+			std::string serialized = record.str();
+			if (serialized == baselineRecords[iterator->second]) continue;
+			changedWriter.Write(entityComponentPair.first);
+			changedWriter.WriteString(serialized);
+		}
+		changedCount++;
+	}
+
+	writer.WriteVector(added);
+	for (const EntityIdType entity : added) {
+		const ComponentIdType componentId = index->entityToComponentMap.at(entity);
+		uint8_t* component = GetSlot(componentId);
+		if (header.bitwise) {
+			writer.WriteBytes(component, elementSize);
+			continue;
+		}
+		record.str({ });
+		serialize(record, component);
+		writer.WriteString(record.str());
+	}
+
+	writer.Write<uint64_t>(changedCount);
+	const std::string changed = changedBuffer.str();
+	writer.WriteBytes(changed.data(), changed.size());
+
+	// added components start out enabled
+	const Bitset baselineDisabled(header.disabledSlots);
+	std::vector<EntityIdType> toggled{ };
+	for (const auto& entityComponentPair : index->entityToComponentMap) {
+		auto iterator = baselineComponents.find(entityComponentPair.first);
+		const bool wasDisabled = iterator != baselineComponents.end() && baselineDisabled.Test(iterator->second);
+		if (disabledSlots.Test(entityComponentPair.second) != wasDisabled)
+			toggled.push_back(entityComponentPair.first);
+	}
+	writer.WriteVector(toggled);
+}
+
+void ComponentStore::ApplyDelta(BinaryReader& reader) {
+	if (!IsSnapshottable())
+		throw std::runtime_error("delta serialization mode does not match registered type");
+	const bool bitwise = !serialize;
+
+	// records are read into a temporary component that is only copied into
+	// the store once it is complete, so a failing record never leaves a
+	// slot destroyed or half written
+	std::vector<uint8_t> staging(elementSize);
+
+	for (const EntityIdType entity : reader.ReadVector<EntityIdType>())
+		RemoveComponent(entity);
+
+	// raw bytes are revived through the copy constructor, see Load()
+	for (const EntityIdType entity : reader.ReadVector<EntityIdType>()) {
+		if (bitwise) {
+			reader.ReadBytes(staging.data(), elementSize);
+			copyConstructor(AllocateComponent(entity), staging.data());
+			continue;
+		}
+		std::istringstream record(reader.ReadString());
+		deserialize(record, staging.data(), entity);
+		copyConstructor(AllocateComponent(entity), staging.data());
+		destructor(staging.data());
+	}
+
+	const auto changedCount = reader.Read<uint64_t>();
+	for (uint64_t i = 0; i < changedCount; i++) {
+		const auto entity = reader.Read<EntityIdType>();
+		void* component = GetComponent(entity);
+		if (bitwise) {
+			// the changed bytes patch a copy of the old component (with the
+			// vtable pointer of this process)
+			copyConstructor(staging.data(), component);
+			try {
+				const auto runCount = reader.Read<uint32_t>();
+				for (uint32_t run = 0; run < runCount; run++) {
+					const auto offset = reader.Read<uint32_t>();
+					const auto length = reader.Read<uint32_t>();
+					if (offset < VTABLE_POINTER_SIZE || static_cast<size_t>(offset) + length > elementSize)
+						throw std::runtime_error("corrupted delta");
+					reader.ReadBytes(staging.data() + offset, length);
+				}
+			} catch (...) {
+				destructor(staging.data());
+				throw;
+			}
+		} else {
+			std::istringstream record(reader.ReadString());
+			deserialize(record, staging.data(), entity);
+		}
+		destructor(component);
+		copyConstructor(component, staging.data());
+		destructor(staging.data());
+	}
+
+	for (const EntityIdType entity : reader.ReadVector<EntityIdType>())
+		SetEnabled(entity, !IsEnabled(entity));
+}
+
+ComponentStoreStats ComponentStore::GetStats() const {
+	ComponentStoreStats stats{ };
+	stats.liveCount = index->entityToComponentMap.size();
+	stats.capacity = pages.size() * componentsPerPage;
+	stats.holeCount = index->freeComponentIds.size();
+	stats.pageCount = pages.size();
+	stats.sharedPageCount = static_cast<size_t>(std::count_if(pages.begin(), pages.end(),
+		[](const std::shared_ptr<uint8_t>& page) -> bool { return page.use_count() > 1; }));
+	stats.bytesAllocated = (stats.capacity * elementSize) + (pages.capacity() * sizeof(pages[0]))
+		+ EstimateHashContainerBytes(index->entityToComponentMap)
+		+ EstimateHashContainerBytes(index->freeComponentIds)
+		+ (disabledSlots.GetWords().capacity() * sizeof(uint64_t));
+#ifdef JUNIA_ECS_STATS
+	stats.pageAllocations = counters.pageAllocations.load(std::memory_order_relaxed);
+	stats.addCalls = counters.addCalls.load(std::memory_order_relaxed);
+	stats.removeCalls = counters.removeCalls.load(std::memory_order_relaxed);
+	stats.getCalls = counters.getCalls.load(std::memory_order_relaxed);
+#endif
+	return stats;
+}
+
+void ComponentStore::SetChangeTracking(bool enabled) {
+	trackChanges = enabled;
+	changedSlots.clear();
+	changedFlags.clear();
+	if (!enabled) return;
+	// observers start out by receiving every live component
+	for (ComponentIdType i = 0; i < count; i++) {
+		if (IsLive(i)) MarkChanged(i);
+	}
+}
+
+std::vector<const void*> ComponentStore::TakeChangedComponents() {
+	const std::lock_guard<std::mutex> lock(changesMutex);
+	std::vector<const void*> components{ };
+	components.reserve(changedSlots.size());
+	for (const ComponentIdType componentId : changedSlots) {
+		changedFlags[componentId] = false;
+		// slots freed since are skipped, their removal has been reported
+		if (IsLive(componentId)) components.push_back(GetSlot(componentId));
+	}
+	changedSlots.clear();
+	return components;
+}
+
+void ComponentStore::SetDoubleBuffered(bool enabled) {
+	if (enabled) {
+		if (readBuffer == nullptr) RebuildReadBuffer();
+		return;
+	}
+	readBuffer.reset();
+	dirtyPages.clear();
+	movedEntities.clear();
+	movedSlots.clear();
+}
+
+bool ComponentStore::IsDoubleBuffered() const {
+	return readBuffer != nullptr;
+}
+
+void ComponentStore::SwapBuffers() {
+	if (readBuffer != nullptr) UpdateReadBuffer();
+}
+
+}  // namespace Junia
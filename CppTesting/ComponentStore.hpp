@@ -1,54 +1,184 @@
-#pragma once
-
-#include "ECS.hpp"
-
-#include <functional>
-#include <memory>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
-#include <unordered_set>
-
-namespace Junia {
-
-class ComponentStore {
-private:
-	using ComponentStoreMapType = std::unordered_map<std::type_index, std::shared_ptr<ComponentStore>>;
-
-	static ComponentStoreMapType& GetComponentStores();
-
-	std::unordered_map<EntityIdType, ComponentIdType> entityToComponentMap{ };
-	std::unordered_set<ComponentIdType> freeComponentIds{ };
-	size_t elementSize = 0;
-	DestructorFunc destructor;
-	CopyConstructorFunc copyConstructor;
-	size_t count = 0;
-	size_t capacity = 0;
-	std::shared_ptr<uint8_t> data = nullptr;
-
-	void ReallocUpsize();
-
-public:
-	static void Create(std::type_index type, size_t size, size_t preallocCount,
-		DestructorFunc destructor, CopyConstructorFunc copyConstructor);
-	static void Destroy(std::type_index type);
-	static std::shared_ptr<ComponentStore> Get(std::type_index type);
-	static void RemoveAllComponents(EntityIdType entity);
-
-	ComponentStore(size_t size, size_t preallocCount, DestructorFunc destructor, CopyConstructorFunc copyConstructor);
-	ComponentStore(const ComponentStore& other);
-	ComponentStore(ComponentStore&& other) noexcept;
-	~ComponentStore();
-
-	ComponentStore& operator=(const ComponentStore& other);
-	ComponentStore& operator=(ComponentStore&& other) noexcept;
-
-	void* AllocateComponent(EntityIdType entity);
-	void RemoveComponent(EntityIdType entity);
-	void* GetComponent(EntityIdType entity);
-
-	size_t GetComponentOffset(EntityIdType entity);
-	void* GetComponentByOffset(size_t offset);
-};
-
-}  // namespace Junia
+#pragma once
+
+#include "Bitset.hpp"
+#include "ECS.hpp"
+#include "MappedFile.hpp"
+#include "Serialization.hpp"
+#include "Stats.hpp"
+#include "World.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Junia {
+
+class ComponentStore {
+private:
+	using ComponentStoreMapType = World::ComponentStoreMapType;
+
+	static ComponentStoreMapType& GetComponentStores();
+
+	/**
+	 * @brief Maps entities to their component slots (shared between copies of
+	 *        a store until one of them changes its structure)
+	*/
+	struct ComponentIndex {
+		std::unordered_map<EntityIdType, ComponentIdType> entityToComponentMap{ };
+		std::unordered_set<ComponentIdType> freeComponentIds{ };
+	};
+
+	std::shared_ptr<ComponentIndex> index;
+	size_t elementSize = 0;
+	size_t componentsPerPage = 1;
+	DestructorFunc destructor;
+	CopyConstructorFunc copyConstructor;
+	SerializeFunc serialize = nullptr;
+	DeserializeFunc deserialize = nullptr;
+	bool rawSnapshot = false;
+	size_t count = 0;
+
+	/**
+	 * @brief Fixed size blocks of components (shared between copies of a store
+	 *        until one of them writes to a page)
+	*/
+	std::vector<std::shared_ptr<uint8_t>> pages{ };
+
+	/**
+	 * @brief The slots of disabled components (skipped by queries, the
+	 *        components stay in place)
+	*/
+	Bitset disabledSlots{ };
+
+	/**
+	 * @brief The slots handed out for writing since the changes have last
+	 *        been taken (only recorded while change tracking is enabled)
+	*/
+	bool trackChanges = false;
+	std::vector<ComponentIdType> changedSlots{ };
+	std::vector<bool> changedFlags{ };
+
+	/**
+	 * @brief Guards the changed slots (components may be written from several
+	 *        threads at once)
+	*/
+	std::mutex changesMutex{ };
+
+	/**
+	 * @brief The pages and index of the store at the last frame boundary that
+	 *        reads are served from (only for double buffered stores, brought
+	 *        up to date at each frame boundary, never shares a page with the
+	 *        store in between)
+	*/
+	std::shared_ptr<ComponentStore> readBuffer{ };
+
+	/**
+	 * @brief What changed since the last frame boundary: a flag per page of
+	 *        the read buffer that is set when the page is written (set
+	 *        atomically, writers may run in parallel), the entities that got
+	 *        or lost a component and the slots they took or freed (only
+	 *        recorded for double buffered stores)
+	*/
+	std::vector<uint8_t> dirtyPages{ };
+	std::vector<EntityIdType> movedEntities{ };
+	std::vector<ComponentIdType> movedSlots{ };
+	bool rebuildReadBuffer = false;
+
+#ifdef JUNIA_ECS_STATS
+	/**
+	 * @brief Call counters of this store (copies of a store start counting
+	 *        from zero)
+	*/
+	struct StoreCounters {
+		std::atomic<uint64_t> pageAllocations{ 0 };
+		std::atomic<uint64_t> addCalls{ 0 };
+		std::atomic<uint64_t> removeCalls{ 0 };
+		std::atomic<uint64_t> getCalls{ 0 };
+	};
+
+	mutable StoreCounters counters{ };
+#endif
+
+	[[nodiscard]] std::shared_ptr<uint8_t> AllocatePage() const;
+	void MakePageUnique(size_t page);
+	void ReleasePage(size_t page);
+	void ReleasePages();
+	ComponentIndex& GetMutableIndex();
+	[[nodiscard]] uint8_t* GetSlot(ComponentIdType componentId) const;
+	uint8_t* GetMutableSlot(ComponentIdType componentId);
+	void MarkChanged(ComponentIdType componentId);
+	[[nodiscard]] bool IsLive(ComponentIdType componentId) const;
+	[[nodiscard]] bool HasValidVtables(uint8_t* data) const;
+	[[nodiscard]] bool MatchesSnapshotMode(bool bitwise) const;
+	void MarkPageDirty(size_t page);
+	void RecordMove(EntityIdType entity, ComponentIdType componentId);
+	void RebuildReadBuffer();
+	void UpdateReadBuffer();
+
+public:
+	static void Create(std::type_index type, size_t size, size_t preallocCount,
+		DestructorFunc destructor, CopyConstructorFunc copyConstructor);
+	static void Destroy(std::type_index type);
+	static std::shared_ptr<ComponentStore> Get(std::type_index type);
+	static void RemoveAllComponents(EntityIdType entity);
+
+	/**
+	 * @brief Make sure all stores can be written to a snapshot (called before
+	 *        anything is written)
+	*/
+	static void CheckAllSnapshottable();
+
+	static void SaveAll(BinaryWriter& writer);
+	static void LoadAll(BinaryReader& reader, const MappedFile* mappedFile = nullptr);
+	static void WriteDeltaAll(BinaryReader& baseline, BinaryWriter& writer);
+	static void ApplyDeltaAll(BinaryReader& reader);
+
+	ComponentStore(size_t size, size_t preallocCount, DestructorFunc destructor, CopyConstructorFunc copyConstructor);
+	ComponentStore(const ComponentStore& other);
+	ComponentStore(ComponentStore&& other) noexcept;
+	~ComponentStore();
+
+	ComponentStore& operator=(const ComponentStore& other);
+	ComponentStore& operator=(ComponentStore&& other) noexcept;
+
+	void* AllocateComponent(EntityIdType entity);
+	void AllocateComponents(const std::vector<EntityIdType>& entities, const BatchConstructorFunc& construct);
+	void RemoveComponent(EntityIdType entity);
+	[[nodiscard]] bool HasComponent(EntityIdType entity) const;
+	void* GetComponent(EntityIdType entity);
+	[[nodiscard]] const void* ReadComponent(EntityIdType entity) const;
+	void SetEnabled(EntityIdType entity, bool enabled);
+	[[nodiscard]] bool IsEnabled(EntityIdType entity) const;
+	[[nodiscard]] bool HasDisabled() const;
+	[[nodiscard]] size_t GetCount() const;
+	[[nodiscard]] std::vector<EntityIdType> GetEntities() const;
+
+	size_t GetComponentOffset(EntityIdType entity);
+	void* GetComponentByOffset(size_t offset);
+
+	void SetSerializer(SerializeFunc serializeFunc, DeserializeFunc deserializeFunc);
+	void SetRawSnapshot();
+	[[nodiscard]] bool IsSnapshottable() const;
+	void Clear();
+	void Save(BinaryWriter& writer);
+	void Load(BinaryReader& reader, const MappedFile* mappedFile = nullptr);
+	void WriteDelta(BinaryReader* baseline, BinaryWriter& writer);
+	void ApplyDelta(BinaryReader& reader);
+
+	[[nodiscard]] ComponentStoreStats GetStats() const;
+
+	void SetDoubleBuffered(bool enabled);
+	[[nodiscard]] bool IsDoubleBuffered() const;
+	void SwapBuffers();
+
+	void SetChangeTracking(bool enabled);
+	std::vector<const void*> TakeChangedComponents();
+};
+
+}  // namespace Junia
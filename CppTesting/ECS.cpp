@@ -1,110 +1,376 @@
-#include "ECS.hpp"
-#include "gsl.hpp"
-#include "IdPool.hpp"
-#include "ComponentStore.hpp"
-
-#include <stdexcept>
-#include <unordered_map>
-#include <unordered_set>
-
-namespace Junia {
-
-static IdPool<EntityIdType>& GetEntityPool() {
-	static IdPool<EntityIdType> pool = IdPool<EntityIdType>();
-	return pool;
-}
-
-// -----------------------------------------------------------------------------
-// ------------------------------ Global functions -----------------------------
-// -----------------------------------------------------------------------------
-
-void RegisterComponent(std::type_index type, size_t size, size_t preallocCount,
-	DestructorFunc destructor, CopyConstructorFunc copyConstructor) {
-	ComponentStore::Create(type, size, preallocCount,
-		std::move(destructor), std::move(copyConstructor));
-}
-
-void UnregisterComponent(std::type_index type) {
-	ComponentStore::Destroy(type);
-}
-
-size_t GetComponentOffset(std::type_index type, EntityIdType entity) {
-	return ComponentStore::Get(type)->GetComponentOffset(entity);
-}
-
-void* GetComponentByOffset(std::type_index type, size_t offset) {
-	return ComponentStore::Get(type)->GetComponentByOffset(offset);
-}
-
-void* AddComponent(std::type_index type, EntityIdType entity) {
-	return ComponentStore::Get(type)->AllocateComponent(entity);
-}
-
-void RemoveComponent(std::type_index type, EntityIdType entity) {
-	ComponentStore::Get(type)->RemoveComponent(entity);
-}
-
-void* GetComponent(std::type_index type, EntityIdType entity) {
-	return ComponentStore::Get(type)->GetComponent(entity);
-}
-
-// -----------------------------------------------------------------------------
-// ---------------------------------- Classes ----------------------------------
-// -----------------------------------------------------------------------------
-
-// --------------------------------- Component ---------------------------------
-
-Component::Component() = default;
-
-Component::~Component() = default;
-
-Component::Component(const Component&) = default;
-
-Component::Component(Component&& other) noexcept
-	: entity(other.entity) { }
-
-Component& Component::operator=(const Component& other) {
-	if (&other == this) return *this;
-	entity = other.entity;
-	return *this;
-}
-
-Component& Component::operator=(Component&& other) noexcept {
-	if (&other == this) return *this;
-	entity = other.entity;
-	return *this;
-}
-
-Entity Component::GetEntity() {
-	return entity;
-}
-
-void Component::SetEntity(EntityIdType entityId) {
-	entity = Entity::Get(entityId);
-}
-
-// ----------------------------------- Entity ----------------------------------
-
-Entity Entity::Create() {
-	return Entity(GetEntityPool().Next());
-}
-
-Entity Entity::Get(EntityIdType entityId) {
-	return Entity(entityId);
-}
-
-void Entity::DestroyEntity(Entity entity) {
-	ComponentStore::RemoveAllComponents(entity.id);
-	GetEntityPool().Free(entity.id);
-}
-
-Entity::Entity() = default;
-
-Entity::Entity(EntityIdType entityId)
-	: id(entityId) { }
-
-EntityIdType Entity::GetId() const {
-	return id;
-}
-
-} // namespace Junia
+#include "ECS.hpp"
+#include "gsl.hpp"
+#include "IdPool.hpp"
+#include "ComponentObserver.hpp"
+#include "ComponentStore.hpp"
+#include "Hierarchy.hpp"
+#include "MappedFile.hpp"
+#include "Serialization.hpp"
+#include "World.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Junia {
+
+/**
+ * @brief Identifies a stream as an ECS snapshot
+*/
+constexpr std::array<char, 4> SNAPSHOT_MAGIC{ 'J', 'E', 'C', 'S' };
+
+/**
+ * @brief Version of the snapshot format (increment on every layout change)
+*/
+constexpr uint32_t SNAPSHOT_VERSION = 6;
+
+/**
+ * @brief Identifies a stream as an ECS delta
+*/
+constexpr std::array<char, 4> DELTA_MAGIC{ 'J', 'E', 'C', 'D' };
+
+/**
+ * @brief Version of the delta format (increment on every layout change)
+*/
+constexpr uint32_t DELTA_VERSION = 4;
+
+/**
+ * @brief The part of a snapshot preceding the component stores
+*/
+struct SnapshotHeader {
+	EntityIdType currentEntityId = 0;
+	std::vector<EntityIdType> freeEntityIds{ };
+	std::vector<EntityIdType> children{ };
+	std::vector<EntityIdType> parents{ };
+	std::vector<uint64_t> disabledEntities{ };
+};
+
+static IdPool<EntityIdType>& GetEntityPool() {
+	return World::GetActiveWorld().GetEntityPool();
+}
+
+static Hierarchy& GetHierarchy() {
+	return World::GetActiveWorld().GetHierarchy();
+}
+
+/**
+ * @brief Write the state of the active world that is not part of a component
+ *        store (entity pool, hierarchy and disabled entities)
+ * @param writer The writer to write to
+*/
+static void WriteEntityState(BinaryWriter& writer) {
+	std::vector<EntityIdType> children{ };
+	std::vector<EntityIdType> parents{ };
+	GetHierarchy().GetRelationships(children, parents);
+	writer.Write(GetEntityPool().GetCurrent());
+	writer.WriteVector(GetEntityPool().GetFreeIds());
+	writer.WriteVector(children);
+	writer.WriteVector(parents);
+	writer.WriteVector(World::GetActiveWorld().GetDisabledEntities().GetWords());
+}
+
+/**
+ * @brief Restore a hierarchy read from a snapshot or delta
+ * @param entityPool The restored entity pool (all entities in the hierarchy
+ *                   have to be in use)
+ * @param children The children (grouped by parent, in order)
+ * @param parents The parent of each child
+ * @return The hierarchy
+*/
+static Hierarchy RestoreHierarchy(const IdPool<EntityIdType>& entityPool,
+	const std::vector<EntityIdType>& children, const std::vector<EntityIdType>& parents) {
+	for (size_t i = 0; i < children.size() && i < parents.size(); i++) {
+		if (!entityPool.IsUsed(children[i]) || !entityPool.IsUsed(parents[i]))
+			throw std::runtime_error("corrupted hierarchy");
+	}
+	Hierarchy hierarchy{ };
+	hierarchy.Restore(children, parents);
+	return hierarchy;
+}
+
+/**
+ * @brief Replace the entity pool of the active world (the ids of entities the
+ *        new pool does not have are released, see World::OnEntityIdReleased())
+ * @param entityPool The restored entity pool
+*/
+static void ReplaceEntityPool(IdPool<EntityIdType> entityPool) {
+	World& world = World::GetActiveWorld();
+	for (EntityIdType entity = 0; entity < GetEntityPool().GetCurrent(); entity++) {
+		if (GetEntityPool().IsUsed(entity) && !entityPool.IsUsed(entity)) world.OnEntityIdReleased(entity);
+	}
+	GetEntityPool() = std::move(entityPool);
+}
+
+static SnapshotHeader ReadSnapshotHeader(BinaryReader& reader) {
+	std::array<char, 4> magic{ };
+	reader.ReadBytes(magic.data(), magic.size());
+	if (magic != SNAPSHOT_MAGIC)
+		throw std::runtime_error("stream does not contain an ECS snapshot");
+	if (reader.Read<uint32_t>() != SNAPSHOT_VERSION)
+		throw std::runtime_error("unsupported snapshot version");
+	SnapshotHeader header{ };
+	header.currentEntityId = reader.Read<EntityIdType>();
+	header.freeEntityIds = reader.ReadVector<EntityIdType>();
+	header.children = reader.ReadVector<EntityIdType>();
+	header.parents = reader.ReadVector<EntityIdType>();
+	header.disabledEntities = reader.ReadVector<uint64_t>();
+	return header;
+}
+
+static void LoadSnapshot(BinaryReader& reader, const MappedFile* mappedFile) {
+	// everything that can fail runs before the first part of the world is
+	// replaced, a corrupted snapshot leaves the world untouched
+	SnapshotHeader header = ReadSnapshotHeader(reader);
+	IdPool<EntityIdType> entityPool = GetEntityPool();
+	entityPool.Restore(header.currentEntityId, std::move(header.freeEntityIds));
+	Hierarchy hierarchy = RestoreHierarchy(entityPool, header.children, header.parents);
+	ComponentStore::LoadAll(reader, mappedFile);
+	ReplaceEntityPool(std::move(entityPool));
+	GetHierarchy() = std::move(hierarchy);
+	World::GetActiveWorld().RestoreDisabledEntities(Bitset(std::move(header.disabledEntities)));
+	World::GetActiveWorld().OnStoresReplaced();
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Global functions -----------------------------
+// -----------------------------------------------------------------------------
+
+void RegisterComponent(std::type_index type, size_t size, size_t preallocCount,
+	DestructorFunc destructor, CopyConstructorFunc copyConstructor) {
+	ComponentStore::Create(type, size, preallocCount,
+		std::move(destructor), std::move(copyConstructor));
+	World::GetActiveWorld().OnStoreReplaced(type);
+}
+
+void UnregisterComponent(std::type_index type) {
+	ComponentStore::Destroy(type);
+	World::GetActiveWorld().OnStoreReplaced(type);
+}
+
+void RegisterComponentSerializer(std::type_index type, SerializeFunc serialize,
+	DeserializeFunc deserialize) {
+	ComponentStore::Get(type)->SetSerializer(std::move(serialize), std::move(deserialize));
+}
+
+void RegisterComponentRawSnapshot(std::type_index type) {
+	ComponentStore::Get(type)->SetRawSnapshot();
+}
+
+void SetComponentDoubleBuffered(std::type_index type, bool enabled) {
+	ComponentStore::Get(type)->SetDoubleBuffered(enabled);
+}
+
+void SaveSnapshot(std::ostream& stream) {
+	ComponentStore::CheckAllSnapshottable();
+	BinaryWriter writer(stream);
+	writer.WriteBytes(SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size());
+	writer.Write(SNAPSHOT_VERSION);
+	WriteEntityState(writer);
+	ComponentStore::SaveAll(writer);
+}
+
+void LoadSnapshot(std::istream& stream) {
+	BinaryReader reader(stream);
+	LoadSnapshot(reader, nullptr);
+}
+
+void LoadSnapshotMapped(const std::string& path) {
+	const MappedFile mappedFile = MappedFile::Open(path);
+	MemoryStreamBuffer buffer(mappedFile.data.get(), mappedFile.size);
+	std::istream stream(&buffer);
+	BinaryReader reader(stream);
+	LoadSnapshot(reader, &mappedFile);
+}
+
+void WriteDelta(std::istream& baseline, std::ostream& delta) {
+	ComponentStore::CheckAllSnapshottable();
+	BinaryReader reader(baseline);
+	ReadSnapshotHeader(reader);
+	BinaryWriter writer(delta);
+	writer.WriteBytes(DELTA_MAGIC.data(), DELTA_MAGIC.size());
+	writer.Write(DELTA_VERSION);
+	WriteEntityState(writer);
+	ComponentStore::WriteDeltaAll(reader, writer);
+}
+
+void ApplyDelta(std::istream& delta) {
+	BinaryReader reader(delta);
+	std::array<char, 4> magic{ };
+	reader.ReadBytes(magic.data(), magic.size());
+	if (magic != DELTA_MAGIC)
+		throw std::runtime_error("stream does not contain an ECS delta");
+	if (reader.Read<uint32_t>() != DELTA_VERSION)
+		throw std::runtime_error("unsupported delta version");
+	const auto current = reader.Read<EntityIdType>();
+	auto freeIds = reader.ReadVector<EntityIdType>();
+	const auto children = reader.ReadVector<EntityIdType>();
+	const auto parents = reader.ReadVector<EntityIdType>();
+	auto disabledEntities = reader.ReadVector<uint64_t>();
+	IdPool<EntityIdType> entityPool = GetEntityPool();
+	entityPool.Restore(current, std::move(freeIds));
+	Hierarchy hierarchy = RestoreHierarchy(entityPool, children, parents);
+	ComponentStore::ApplyDeltaAll(reader);
+	ReplaceEntityPool(std::move(entityPool));
+	GetHierarchy() = std::move(hierarchy);
+	World::GetActiveWorld().RestoreDisabledEntities(Bitset(std::move(disabledEntities)));
+	World::GetActiveWorld().OnStoresReplaced();
+}
+
+void RegisterComponentObserver(std::type_index type, const std::shared_ptr<ComponentObserver>& observer) {
+	World::GetActiveWorld().RegisterObserver(type, observer);
+}
+
+void FlushComponentChanges(std::type_index type) {
+	World::GetActiveWorld().FlushChanges(type);
+}
+
+size_t GetComponentOffset(std::type_index type, EntityIdType entity) {
+	return ComponentStore::Get(type)->GetComponentOffset(entity);
+}
+
+void* GetComponentByOffset(std::type_index type, size_t offset) {
+	return ComponentStore::Get(type)->GetComponentByOffset(offset);
+}
+
+void* AddComponent(std::type_index type, EntityIdType entity) {
+	void* component = ComponentStore::Get(type)->AllocateComponent(entity);
+	World::GetActiveWorld().OnComponentAdded(type, entity);
+	return component;
+}
+
+void AddComponents(std::type_index type, const std::vector<EntityIdType>& entities,
+	const BatchConstructorFunc& construct) {
+	ComponentStore::Get(type)->AllocateComponents(entities, construct);
+	World::GetActiveWorld().OnComponentsAdded(type, entities);
+}
+
+void RemoveComponent(std::type_index type, EntityIdType entity) {
+	ComponentStore::Get(type)->RemoveComponent(entity);
+	World::GetActiveWorld().OnComponentRemoved(type, entity);
+}
+
+bool HasComponent(std::type_index type, EntityIdType entity) {
+	return ComponentStore::Get(type)->HasComponent(entity);
+}
+
+uint32_t GetEntityGeneration(EntityIdType entity) {
+	return World::GetActiveWorld().GetEntityGeneration(entity);
+}
+
+void SetComponentEnabled(std::type_index type, EntityIdType entity, bool enabled) {
+	ComponentStore::Get(type)->SetEnabled(entity, enabled);
+	World::GetActiveWorld().OnComponentEnabledChanged(type, entity);
+}
+
+bool IsComponentEnabled(std::type_index type, EntityIdType entity) {
+	return ComponentStore::Get(type)->IsEnabled(entity);
+}
+
+void* GetComponent(std::type_index type, EntityIdType entity) {
+	return ComponentStore::Get(type)->GetComponent(entity);
+}
+
+const void* ReadComponent(std::type_index type, EntityIdType entity) {
+	return ComponentStore::Get(type)->ReadComponent(entity);
+}
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Classes ----------------------------------
+// -----------------------------------------------------------------------------
+
+// --------------------------------- Component ---------------------------------
+
+Component::Component() = default;
+
+Component::~Component() = default;
+
+Component::Component(const Component&) = default;
+
+Component::Component(Component&& other) noexcept
+	: entity(other.entity) { }
+
+Component& Component::operator=(const Component& other) {
+	if (&other == this) return *this;
+	entity = other.entity;
+	return *this;
+}
+
+Component& Component::operator=(Component&& other) noexcept {
+	if (&other == this) return *this;
+	entity = other.entity;
+	return *this;
+}
+
+Entity Component::GetEntity() const {
+	return entity;
+}
+
+void Component::SetEntity(EntityIdType entityId) {
+	entity = Entity::Get(entityId);
+}
+
+// ----------------------------------- Entity ----------------------------------
+
+Entity Entity::Create() {
+	return Entity(GetEntityPool().Next());
+}
+
+Entity Entity::Get(EntityIdType entityId) {
+	if (!GetEntityPool().IsUsed(entityId)) throw std::runtime_error("entity does not exist");
+	return Entity(entityId);
+}
+
+void Entity::DestroyEntity(Entity entity) {
+	if (!GetEntityPool().IsUsed(entity.id)) throw std::runtime_error("entity does not exist");
+	for (const EntityIdType entityId : GetHierarchy().RemoveSubtree(entity.id)) {
+		ComponentStore::RemoveAllComponents(entityId);
+		World::GetActiveWorld().OnEntityDestroyed(entityId);
+		GetEntityPool().Free(entityId);
+	}
+}
+
+void Entity::SetParent(Entity parent) {
+	if (!GetEntityPool().IsUsed(id) || !GetEntityPool().IsUsed(parent.id))
+		throw std::runtime_error("entity does not exist");
+	GetHierarchy().SetParent(id, parent.id);
+}
+
+void Entity::RemoveParent() {
+	GetHierarchy().RemoveParent(id);
+}
+
+bool Entity::HasParent() const {
+	return GetHierarchy().HasParent(id);
+}
+
+Entity Entity::GetParent() const {
+	return Entity(GetHierarchy().GetParent(id));
+}
+
+std::vector<Entity> Entity::GetChildren() const {
+	const std::vector<EntityIdType>& children = GetHierarchy().GetChildren(id);
+	std::vector<Entity> entities{ };
+	entities.reserve(children.size());
+	for (const EntityIdType child : children) entities.push_back(Entity(child));
+	return entities;
+}
+
+void Entity::SetEnabled(bool enabled) {
+	World::GetActiveWorld().SetEntityEnabled(id, enabled);
+}
+
+bool Entity::IsEnabled() const {
+	return World::GetActiveWorld().IsEntityEnabled(id);
+}
+
+Entity::Entity() = default;
+
+Entity::Entity(EntityIdType entityId)
+	: id(entityId) { }
+
+EntityIdType Entity::GetId() const {
+	return id;
+}
+
+} // namespace Junia
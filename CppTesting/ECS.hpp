@@ -1,311 +1,665 @@
-#pragma once
-
-#include "concepts.hpp"
-
-#include <cstdint>
-#include <functional>
-#include <memory>
-#include <typeindex>
-#include <typeinfo>
-
-namespace Junia {
-
-// -----------------------------------------------------------------------------
-// ----------------------------- Using declarations ----------------------------
-// -----------------------------------------------------------------------------
-
-/**
- * @brief Type for EntityIDs
-*/
-using EntityIdType = uint32_t;
-
-/**
- * @brief Type for ComponentIDs
-*/
-using ComponentIdType = size_t;
-
-/**
- * @brief A function calling the destructor for the passed in pointer (actual
- *        pointer type context dependent)
-*/
-using DestructorFunc = std::function<void(void*)>;
-
-/**
- * @brief A function calling the copy constructor to copy the object from the
- *        second parameter to the first parameter
-*/
-using CopyConstructorFunc = std::function<void(void*, void*)>;
-
-// -----------------------------------------------------------------------------
-// --------------------------------- Functions ---------------------------------
-// -----------------------------------------------------------------------------
-
-size_t GetComponentOffset(std::type_index type, EntityIdType entity);
-void* GetComponentByOffset(std::type_index type, size_t offset);
-
-/**
- * @brief Register a component type
- * @param type The component type
- * @param size the size of the type in bytes
- * @param destructor A function calling the destructor for an instance of type
- * @param copyConstructor A function calling the copy constructor for type
-*/
-void RegisterComponent(std::type_index type, size_t size, size_t preallocCount,
-	DestructorFunc destructor, CopyConstructorFunc copyConstructor);
-
-/**
- * @brief Unregister a component type
- * @param type The component type
-*/
-void UnregisterComponent(std::type_index type);
-
-/**
- * @brief Add a component to an entity (only allocates! use std::construct_at()
- *        to initialize memory)
- * @param type The component type to add
- * @param entity The id of the entity to add the component to
- * @return A pointer to the start of the memory where the component can be
- *         constructed
-*/
-void* AddComponent(std::type_index type, EntityIdType entity);
-
-/**
- * @brief Remove a component from an entity (also calls destructor on the
- *        memory)
- * @param type The component type to remove
- * @param entity The id of the entity to remove the component from
-*/
-void RemoveComponent(std::type_index type, EntityIdType entity);
-
-/**
- * @brief Get the component for an entity
- * @param type The component type to get
- * @param entity The id of the entity to get the component from
- * @return A pointer to the first byte of memory of the component
-*/
-void* GetComponent(std::type_index type, EntityIdType entity);
-
-// -----------------------------------------------------------------------------
-// ---------------------------------- Classes ----------------------------------
-// -----------------------------------------------------------------------------
-
-// Forward declaration for use in Enity class
-class Component;
-
-/**
- * @brief Wrapper for ECS Entities
-*/
-class Entity {
-private:
-	/**
-	 * @brief The ID of the entity
-	*/
-	EntityIdType id = 0;
-
-	/**
-	 * @brief Entity constructor by ID (does not register entity), see
-	 *        Junia::Entity::Create() for entity creation
-	 * @param entityId The ID of the entity
-	*/
-	explicit Entity(EntityIdType entityId);
-
-public:
-	/**
-	 * @brief Entity constructor for temporary placeholders (not safe for use),
-	 *        see Junia::Entity::Create() for entity creation
-	*/
-	Entity();
-
-	/**
-	 * @brief Get the ID
-	 * @return The ID of the entity
-	*/
-	[[nodiscard]] EntityIdType GetId() const;
-
-	/**
-	 * @brief Create an entity
-	 * @return An Entity instance wrapping the created entity
-	*/
-	static Entity Create();
-
-	/**
-	 * @brief Get an entity by id
-	 * @param id The id of the entity to get
-	 * @return An entity instance wrapping the entity
-	*/
-	static Entity Get(EntityIdType entityId);
-
-	/**
-	 * @brief Destroy an entity
-	 * @param entity The entity to destroy
-	*/
-	static void DestroyEntity(Entity entity);
-
-	/**
-	 * @brief Add a component
-	 * @tparam T The type of the component to add
-	 * @tparam ...TArgs The types of the parameters to pass to the component
-	 *                  constructor
-	 * @param ...args The parameters to pass to the component constructor
-	 * @return A reference to the newly created component
-	*/
-	template<TypenameDerivedFrom<Component> T, typename... TArgs>
-	T& AddComponent(TArgs... args);
-
-	/**
-	 * @brief Remove a component
-	 * @tparam T The type of the component to remove
-	*/
-	template<TypenameDerivedFrom<Component> T>
-	void RemoveComponent();
-
-	/**
-	 * @brief Get a component (that has been previously added)
-	 * @tparam T The type of the component to get
-	 * @return A reference to the component
-	*/
-	template<TypenameDerivedFrom<Component> T>
-	T& GetComponent();
-};
-
-/**
- * @brief Abstract class for deriving components from
-*/
-class Component {
-private:
-	/**
-	 * @brief The entity this component is attached to
-	*/
-	Entity entity{ };
-
-public:
-	Component();
-	virtual ~Component() = 0;
-	Component(const Component& other);
-	Component(Component&& other) noexcept;
-
-	Component& operator=(const Component& other);
-	Component& operator=(Component&& other) noexcept;
-
-	/**
-	 * @brief Get the entity this component is attached to
-	 * @return An Entity instace wrapping the entity
-	*/
-	Entity GetEntity();
-
-	/**
-	 * @brief INTERNAL USE ONLY - THIS ONLY SETS THE MEMBER
-	 * @param id The id of the entity
-	*/
-	void SetEntity(EntityIdType entityId);
-
-	/**
-	 * @brief Register a component
-	 * @tparam T The type of the component to register
-	*/
-	template<TypenameDerivedFrom<Component> T>
-	static inline void Register(size_t preallocCount = 1);
-
-	/**
-	 * @brief Unregister a component (also removes it from all entities)
-	 * @tparam T The type of the component to unregister
-	*/
-	template<TypenameDerivedFrom<Component> T>
-	static inline void Unregister();
-};
-
-/**
- * @brief A reference to a component (stays valid after reallocation)
- * @tparam T The type of the component to reference
-*/
-template<TypenameDerivedFrom<Component> T>
-struct ComponentRef {
-private:
-	/**
-	 * @brief The offset of the component in the ComponentStore memory
-	*/
-	size_t offset;
-
-public:
-	/**
-	 * @brief Constructor for placeholder instances (see other constructors for
-	 *        ComponentRef creation)
-	*/
-	ComponentRef();
-	explicit ComponentRef(Entity entity);
-	explicit ComponentRef(T& component);
-
-	T* operator->();
-	T& operator*();
-};
-
-// -----------------------------------------------------------------------------
-// ------------------------------ Implementations ------------------------------
-// -----------------------------------------------------------------------------
-
-// ----------------------------------- Entity ----------------------------------
-
-template<TypenameDerivedFrom<Component> T, typename ...TArgs>
-inline T& Entity::AddComponent(TArgs ...args) {
-	T* componentAddress = static_cast<T*>(Junia::AddComponent(typeid(T), id));
-	std::construct_at<T>(componentAddress, args...);
-	componentAddress->SetEntity(id);
-	return *componentAddress;
-}
-
-template<TypenameDerivedFrom<Component> T>
-inline void Entity::RemoveComponent() {
-	Junia::RemoveComponent(typeid(T), id);
-}
-
-template<TypenameDerivedFrom<Component> T>
-inline T& Entity::GetComponent() {
-	return *static_cast<T*>(Junia::GetComponent(typeid(T), id));
-}
-
-// --------------------------------- Component ---------------------------------
-
-template<TypenameDerivedFrom<Component> T>
-inline void Component::Register(size_t preallocCount) {
-	Junia::RegisterComponent(typeid(T), sizeof(T), preallocCount,
-		[](void* ptr) -> void {
-			std::destroy_at<T>(static_cast<T*>(ptr));
-		},
-		[](void* destination, void* origin) -> void {
-			std::construct_at<T>(
-				static_cast<T*>(destination),
-				*static_cast<T*>(origin));
-		});
-}
-
-template<TypenameDerivedFrom<Component> T>
-inline void Component::Unregister() {
-	UnregisterComponent(typeid(T));
-}
-
-// ------------------------------ ComponentRef<T> ------------------------------
-
-template<TypenameDerivedFrom<Component> T>
-inline ComponentRef<T>::ComponentRef()
-	: offset(0) { }
-
-template<TypenameDerivedFrom<Component> T>
-inline ComponentRef<T>::ComponentRef(Entity entity)
-	: offset(GetComponentOffset(typeid(T), entity.GetId())) { }
-
-template<TypenameDerivedFrom<Component> T>
-inline ComponentRef<T>::ComponentRef(T& component)
-	: offset(GetComponentOffset(typeid(T),
-		component.GetEntity().GetId())) { }
-
-template<TypenameDerivedFrom<Component> T>
-inline T* ComponentRef<T>::operator->() {
-	return static_cast<T*>(GetComponentByOffset(typeid(T), offset));
-}
-
-template<TypenameDerivedFrom<Component> T>
-inline T& ComponentRef<T>::operator*() {
-	return *static_cast<T*>(GetComponentByOffset(typeid(T), offset));
-}
-
-} // namespace Junia
+#pragma once
+
+#include "concepts.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ----------------------------- Using declarations ----------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Type for EntityIDs
+*/
+using EntityIdType = uint32_t;
+
+/**
+ * @brief Type for ComponentIDs
+*/
+using ComponentIdType = size_t;
+
+/**
+ * @brief A function calling the destructor for the passed in pointer (actual
+ *        pointer type context dependent)
+*/
+using DestructorFunc = std::function<void(void*)>;
+
+/**
+ * @brief A function calling the copy constructor to copy the object from the
+ *        second parameter to the first parameter
+*/
+using CopyConstructorFunc = std::function<void(void*, void*)>;
+
+/**
+ * @brief A function constructing components for a batch of entities: the
+ *        first parameter points to the first of a run of consecutive
+ *        component slots, the second is the length of the run and the third
+ *        points to the ids of the entities the components belong to (if it
+ *        throws, none of the components of the run may be left constructed)
+*/
+using BatchConstructorFunc = std::function<void(void*, size_t, const EntityIdType*)>;
+
+/**
+ * @brief A function writing the object passed in as the second parameter to
+ *        the stream
+*/
+using SerializeFunc = std::function<void(std::ostream&, void*)>;
+
+/**
+ * @brief A function constructing an object at the memory passed in as the
+ *        second parameter from the data in the stream, owned by the entity
+ *        passed in as the third parameter
+*/
+using DeserializeFunc = std::function<void(std::istream&, void*, EntityIdType)>;
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Functions ---------------------------------
+// -----------------------------------------------------------------------------
+
+size_t GetComponentOffset(std::type_index type, EntityIdType entity);
+void* GetComponentByOffset(std::type_index type, size_t offset);
+
+/**
+ * @brief Register a component type
+ * @param type The component type
+ * @param size the size of the type in bytes
+ * @param destructor A function calling the destructor for an instance of type
+ * @param copyConstructor A function calling the copy constructor for type
+*/
+void RegisterComponent(std::type_index type, size_t size, size_t preallocCount,
+	DestructorFunc destructor, CopyConstructorFunc copyConstructor);
+
+/**
+ * @brief Unregister a component type
+ * @param type The component type
+*/
+void UnregisterComponent(std::type_index type);
+
+/**
+ * @brief Register snapshot serialization hooks for a component type (types
+ *        without hooks are only written to snapshots if they opt in to raw
+ *        bytes, see Junia::RegisterComponentRawSnapshot(), otherwise
+ *        Junia::SaveSnapshot() throws)
+ * @param type The component type
+ * @param serialize A function writing an instance of type to a stream
+ * @param deserialize A function constructing an instance of type from a
+ *                    stream
+*/
+void RegisterComponentSerializer(std::type_index type, SerializeFunc serialize,
+	DeserializeFunc deserialize);
+
+/**
+ * @brief Allow a component type without serialization hooks to be written to
+ *        snapshots as raw bytes (see Junia::RawSnapshotComponent). Its
+ *        components are revived through the copy constructor when loaded, or
+ *        used in place when mapped by the same executable image.
+ * @param type The component type
+*/
+void RegisterComponentRawSnapshot(std::type_index type);
+
+/**
+ * @brief Make a component type double buffered (or single buffered again):
+ *        reads (Junia::ReadComponent()) see the components as they were at
+ *        the last World::EndFrame(), writes go to a separate copy that
+ *        becomes visible to reads at the next World::EndFrame(). Systems
+ *        reading and writing the same type can therefore run in parallel
+ *        (as long as no two write the same component and no components are
+ *        added or removed) and see the same state regardless of their order.
+ *        Every frame boundary copies the pages written during the frame.
+ *        Writes to pages still shared with a fork (see World::Fork()) must
+ *        not run in parallel, the first write to a shared page replaces it.
+ * @param type The component type
+ * @param enabled Whether to double buffer the type
+*/
+void SetComponentDoubleBuffered(std::type_index type, bool enabled);
+
+/**
+ * @brief Write the state of the ECS (entity pool, hierarchy, enabled states
+ *        and all component stores) to a stream. Components of types without
+ *        serialization hooks are written as one raw block per store, which
+ *        they have to opt in to (see Junia::RawSnapshotComponent), otherwise
+ *        std::runtime_error is thrown before anything is written. Type
+ *        identification relies on std::type_info::name(), so snapshots can
+ *        only be loaded by binaries built with the same compiler.
+ * @param stream The (binary) stream to write to
+*/
+void SaveSnapshot(std::ostream& stream);
+
+/**
+ * @brief Replace the state of the ECS with a snapshot written by
+ *        Junia::SaveSnapshot(). All component types in the snapshot must be
+ *        registered, stores that are not part of the snapshot are cleared.
+ *        The world is only changed once the whole snapshot has been read, a
+ *        snapshot that fails to load (std::runtime_error) leaves it as it
+ *        was.
+ * @param stream The (binary) stream to read from
+*/
+void LoadSnapshot(std::istream& stream);
+
+/**
+ * @brief Replace the state of the ECS with a snapshot file by mapping it into
+ *        memory copy-on-write. Stores of raw snapshot types (see
+ *        Junia::RawSnapshotComponent) whose vtable pointers in the file are
+ *        valid in this process use the mapped pages as their data directly:
+ *        nothing is copied until a page is written to (the page is then
+ *        copy constructed), and read only pages are shared between all
+ *        processes mapping the file. The vtable pointers only match if the
+ *        snapshot has been written by the same executable image loaded to the
+ *        same address (the same process, a forked process or a build without
+ *        address space layout randomization), a cold start of a randomized
+ *        executable revives the components like Junia::LoadSnapshot().
+ * @param path The path of the snapshot file
+*/
+void LoadSnapshotMapped(const std::string& path);
+
+/**
+ * @brief Write the difference between a snapshot and the current state of the
+ *        ECS: the entity pool, hierarchy and disabled entities, removed and
+ *        added components, for changed components either the changed byte
+ *        ranges (stores without serialization hooks) or the whole serialized
+ *        component, and the components that have been enabled or disabled
+ * @param baseline A (binary) stream containing a snapshot written by
+ *                 Junia::SaveSnapshot()
+ * @param delta The (binary) stream to write the delta to
+*/
+void WriteDelta(std::istream& baseline, std::ostream& delta);
+
+/**
+ * @brief Apply a delta written by Junia::WriteDelta() (the ECS has to be in
+ *        the state of the baseline snapshot the delta was created from). A
+ *        delta that fails to apply leaves the ECS as it was.
+ * @param delta The (binary) stream to read the delta from
+*/
+void ApplyDelta(std::istream& delta);
+
+/**
+ * @brief Add a component to an entity (only allocates! use std::construct_at()
+ *        to initialize memory)
+ * @param type The component type to add
+ * @param entity The id of the entity to add the component to
+ * @return A pointer to the start of the memory where the component can be
+ *         constructed
+*/
+void* AddComponent(std::type_index type, EntityIdType entity);
+
+/**
+ * @brief Add a component to a batch of entities with a single store lookup
+ *        (the components fill the holes of the store first, in runs of
+ *        consecutive slots, and none are added if constructing one throws)
+ * @param type The component type to add
+ * @param entities The ids of the entities to add the component to
+ * @param construct A function constructing the components in their slots
+*/
+void AddComponents(std::type_index type, const std::vector<EntityIdType>& entities,
+	const BatchConstructorFunc& construct);
+
+/**
+ * @brief Remove a component from an entity (also calls destructor on the
+ *        memory)
+ * @param type The component type to remove
+ * @param entity The id of the entity to remove the component from
+*/
+void RemoveComponent(std::type_index type, EntityIdType entity);
+
+/**
+ * @brief Check whether an entity has a component
+ * @param type The component type to check for
+ * @param entity The id of the entity to check
+ * @return true if the entity has a component of type, false otherwise
+*/
+bool HasComponent(std::type_index type, EntityIdType entity);
+
+/**
+ * @brief Get the generation of an entity id (changes whenever the entity
+ *        holding the id is destroyed, so a stored generation tells whether the
+ *        id has been handed out to another entity since)
+ * @param entity The id of the entity
+ * @return The generation of the id
+*/
+uint32_t GetEntityGeneration(EntityIdType entity);
+
+/**
+ * @brief Enable or disable the component of an entity (disabled components
+ *        stay in place but their entities are skipped when iterating queries
+ *        involving the type, see Junia::Query::ForEach())
+ * @param type The component type
+ * @param entity The id of the entity having the component
+ * @param enabled Whether the component is enabled
+*/
+void SetComponentEnabled(std::type_index type, EntityIdType entity, bool enabled);
+
+/**
+ * @brief Check whether the component of an entity is enabled
+ * @param type The component type
+ * @param entity The id of the entity having the component
+ * @return true unless the component has been disabled
+*/
+bool IsComponentEnabled(std::type_index type, EntityIdType entity);
+
+/**
+ * @brief Get the component for an entity
+ * @param type The component type to get
+ * @param entity The id of the entity to get the component from
+ * @return A pointer to the first byte of memory of the component
+*/
+void* GetComponent(std::type_index type, EntityIdType entity);
+
+/**
+ * @brief Get the component for an entity for reading only (does not copy the
+ *        component page if it is shared with a forked world). For double
+ *        buffered types this is the component as of the last frame boundary
+ *        (components added since are returned as they are).
+ * @param type The component type to get
+ * @param entity The id of the entity to get the component from
+ * @return A pointer to the first byte of memory of the component
+*/
+const void* ReadComponent(std::type_index type, EntityIdType entity);
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Classes ----------------------------------
+// -----------------------------------------------------------------------------
+
+// Forward declaration for use in Enity class
+class Component;
+
+/**
+ * @brief Wrapper for ECS Entities
+*/
+class Entity {
+private:
+	/**
+	 * @brief The ID of the entity
+	*/
+	EntityIdType id = 0;
+
+	/**
+	 * @brief Entity constructor by ID (does not register entity), see
+	 *        Junia::Entity::Create() for entity creation
+	 * @param entityId The ID of the entity
+	*/
+	explicit Entity(EntityIdType entityId);
+
+public:
+	/**
+	 * @brief Entity constructor for temporary placeholders (not safe for use),
+	 *        see Junia::Entity::Create() for entity creation
+	*/
+	Entity();
+
+	/**
+	 * @brief Get the ID
+	 * @return The ID of the entity
+	*/
+	[[nodiscard]] EntityIdType GetId() const;
+
+	/**
+	 * @brief Create an entity
+	 * @return An Entity instance wrapping the created entity
+	*/
+	static Entity Create();
+
+	/**
+	 * @brief Get an entity by id (throws std::runtime_error if no entity with
+	 *        the id exists)
+	 * @param id The id of the entity to get
+	 * @return An entity instance wrapping the entity
+	*/
+	static Entity Get(EntityIdType entityId);
+
+	/**
+	 * @brief Destroy an entity and all of its descendants (throws
+	 *        std::runtime_error if the entity does not exist)
+	 * @param entity The entity to destroy
+	*/
+	static void DestroyEntity(Entity entity);
+
+	/**
+	 * @brief Make the entity a child of another entity (detaches it from its
+	 *        previous parent, throws std::runtime_error if either entity does
+	 *        not exist, or if the parent is the entity itself or one of its
+	 *        descendants)
+	 * @param parent The new parent
+	*/
+	void SetParent(Entity parent);
+
+	/**
+	 * @brief Detach the entity from its parent (making it a root)
+	*/
+	void RemoveParent();
+
+	/**
+	 * @brief Check whether the entity has a parent
+	 * @return true if the entity is a child of another entity, false otherwise
+	*/
+	[[nodiscard]] bool HasParent() const;
+
+	/**
+	 * @brief Get the parent (throws std::runtime_error if there is none)
+	 * @return An Entity instance wrapping the parent
+	*/
+	[[nodiscard]] Entity GetParent() const;
+
+	/**
+	 * @brief Get the direct children
+	 * @return The children in the order they have been parented
+	*/
+	[[nodiscard]] std::vector<Entity> GetChildren() const;
+
+	/**
+	 * @brief Enable or disable the entity without touching its components
+	 *        (disabled entities are skipped when iterating queries)
+	 * @param enabled Whether the entity is enabled
+	*/
+	void SetEnabled(bool enabled);
+
+	/**
+	 * @brief Check whether the entity is enabled
+	 * @return true unless the entity has been disabled
+	*/
+	[[nodiscard]] bool IsEnabled() const;
+
+	/**
+	 * @brief Add a component
+	 * @tparam T The type of the component to add
+	 * @tparam ...TArgs The types of the parameters to pass to the component
+	 *                  constructor
+	 * @param ...args The parameters to pass to the component constructor
+	 * @return A reference to the newly created component
+	*/
+	template<TypenameDerivedFrom<Component> T, typename... TArgs>
+	T& AddComponent(TArgs&&... args);
+
+	/**
+	 * @brief Remove a component
+	 * @tparam T The type of the component to remove
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	void RemoveComponent();
+
+	/**
+	 * @brief Check whether the entity has a component
+	 * @tparam T The type of the component to check for
+	 * @return true if the entity has a component of type T, false otherwise
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	[[nodiscard]] bool HasComponent() const;
+
+	/**
+	 * @brief Enable or disable a component (that has been previously added)
+	 *        without removing it, see Junia::SetComponentEnabled()
+	 * @tparam T The type of the component
+	 * @param enabled Whether the component is enabled
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	void SetComponentEnabled(bool enabled);
+
+	/**
+	 * @brief Check whether a component (that has been previously added) is
+	 *        enabled
+	 * @tparam T The type of the component
+	 * @return true unless the component has been disabled
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	[[nodiscard]] bool IsComponentEnabled() const;
+
+	/**
+	 * @brief Get a component (that has been previously added)
+	 * @tparam T The type of the component to get
+	 * @return A reference to the component
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	T& GetComponent();
+
+	/**
+	 * @brief Get a component (that has been previously added) for reading only
+	 *        (as of the last frame boundary for double buffered types, see
+	 *        Junia::SetComponentDoubleBuffered())
+	 * @tparam T The type of the component to get
+	 * @return A const reference to the component
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	const T& ReadComponent() const;
+};
+
+/**
+ * @brief Abstract class for deriving components from
+*/
+class Component {
+private:
+	/**
+	 * @brief The entity this component is attached to
+	*/
+	Entity entity{ };
+
+public:
+	Component();
+	virtual ~Component() = 0;
+	Component(const Component& other);
+	Component(Component&& other) noexcept;
+
+	Component& operator=(const Component& other);
+	Component& operator=(Component&& other) noexcept;
+
+	/**
+	 * @brief Get the entity this component is attached to
+	 * @return An Entity instace wrapping the entity
+	*/
+	[[nodiscard]] Entity GetEntity() const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - THIS ONLY SETS THE MEMBER
+	 * @param id The id of the entity
+	*/
+	void SetEntity(EntityIdType entityId);
+
+	/**
+	 * @brief Register a component (types providing
+	 *        Serialize(std::ostream&) const and Deserialize(std::istream&)
+	 *        members also get their snapshot serialization hooks registered,
+	 *        types satisfying Junia::RawSnapshotComponent are written to
+	 *        snapshots as raw bytes)
+	 * @tparam T The type of the component to register
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	static inline void Register(size_t preallocCount = 1);
+
+	/**
+	 * @brief Unregister a component (also removes it from all entities)
+	 * @tparam T The type of the component to unregister
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	static inline void Unregister();
+
+	/**
+	 * @brief Make a component double buffered, see
+	 *        Junia::SetComponentDoubleBuffered()
+	 * @tparam T The type of the component
+	 * @param enabled Whether to double buffer the component
+	*/
+	template<TypenameDerivedFrom<Component> T>
+	static inline void SetDoubleBuffered(bool enabled = true);
+};
+
+/**
+ * @brief A reference to a component (stays valid after reallocation)
+ * @tparam T The type of the component to reference
+*/
+template<TypenameDerivedFrom<Component> T>
+struct ComponentRef {
+private:
+	/**
+	 * @brief The offset of the component in the ComponentStore memory
+	*/
+	size_t offset;
+
+	/**
+	 * @brief The entity the component is attached to and the generation of
+	 *        its id (see Junia::GetEntityGeneration())
+	*/
+	Entity entity{ };
+	uint32_t generation = 0;
+
+public:
+	/**
+	 * @brief Constructor for placeholder instances (see other constructors for
+	 *        ComponentRef creation)
+	*/
+	ComponentRef();
+	explicit ComponentRef(Entity entity);
+	explicit ComponentRef(T& component);
+
+	T* operator->();
+	T& operator*();
+
+	/**
+	 * @brief Get the entity the component is attached to
+	 * @return An Entity instance wrapping the entity
+	*/
+	[[nodiscard]] Entity GetEntity() const;
+
+	/**
+	 * @brief Point the reference at the component of the entity again (its
+	 *        slot may have changed, e.g. by loading a snapshot)
+	 * @return true if the entity still exists and has a component of type T,
+	 *         false otherwise (also once its id has been handed out to another
+	 *         entity, the reference must not be dereferenced then)
+	*/
+	bool Revalidate();
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// ----------------------------------- Entity ----------------------------------
+
+template<TypenameDerivedFrom<Component> T, typename ...TArgs>
+inline T& Entity::AddComponent(TArgs&& ...args) {
+	T* componentAddress = static_cast<T*>(Junia::AddComponent(typeid(T), id));
+	std::construct_at<T>(componentAddress, std::forward<TArgs>(args)...);
+	componentAddress->SetEntity(id);
+	return *componentAddress;
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline void Entity::RemoveComponent() {
+	Junia::RemoveComponent(typeid(T), id);
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline bool Entity::HasComponent() const {
+	return Junia::HasComponent(typeid(T), id);
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline void Entity::SetComponentEnabled(bool enabled) {
+	Junia::SetComponentEnabled(typeid(T), id, enabled);
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline bool Entity::IsComponentEnabled() const {
+	return Junia::IsComponentEnabled(typeid(T), id);
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline T& Entity::GetComponent() {
+	return *static_cast<T*>(Junia::GetComponent(typeid(T), id));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline const T& Entity::ReadComponent() const {
+	return *static_cast<const T*>(Junia::ReadComponent(typeid(T), id));
+}
+
+// --------------------------------- Component ---------------------------------
+
+template<TypenameDerivedFrom<Component> T>
+inline void Component::Register(size_t preallocCount) {
+	static_assert(!(Serializable<T> && RawSnapshotComponent<T>),
+		"components are either written through their serialization hooks or as raw bytes");
+	Junia::RegisterComponent(typeid(T), sizeof(T), preallocCount,
+		[](void* ptr) -> void {
+			std::destroy_at<T>(static_cast<T*>(ptr));
+		},
+		[](void* destination, void* origin) -> void {
+			std::construct_at<T>(
+				static_cast<T*>(destination),
+				*static_cast<T*>(origin));
+		});
+	if constexpr (Serializable<T>) {
+		Junia::RegisterComponentSerializer(typeid(T),
+			[](std::ostream& stream, void* ptr) -> void {
+				static_cast<T*>(ptr)->Serialize(stream);
+			},
+			[](std::istream& stream, void* ptr, EntityIdType entity) -> void {
+				T* component = std::construct_at<T>(static_cast<T*>(ptr));
+				component->SetEntity(entity);
+				component->Deserialize(stream);
+			});
+	} else if constexpr (RawSnapshotComponent<T>) {
+		Junia::RegisterComponentRawSnapshot(typeid(T));
+	}
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline void Component::Unregister() {
+	UnregisterComponent(typeid(T));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline void Component::SetDoubleBuffered(bool enabled) {
+	SetComponentDoubleBuffered(typeid(T), enabled);
+}
+
+// ------------------------------ ComponentRef<T> ------------------------------
+
+template<TypenameDerivedFrom<Component> T>
+inline ComponentRef<T>::ComponentRef()
+	: offset(0) { }
+
+template<TypenameDerivedFrom<Component> T>
+inline ComponentRef<T>::ComponentRef(Entity entity)
+	: offset(GetComponentOffset(typeid(T), entity.GetId())), entity(entity),
+	generation(GetEntityGeneration(entity.GetId())) { }
+
+template<TypenameDerivedFrom<Component> T>
+inline ComponentRef<T>::ComponentRef(T& component)
+	: offset(GetComponentOffset(typeid(T),
+		component.GetEntity().GetId())), entity(component.GetEntity()),
+	generation(GetEntityGeneration(entity.GetId())) { }
+
+template<TypenameDerivedFrom<Component> T>
+inline T* ComponentRef<T>::operator->() {
+	return static_cast<T*>(GetComponentByOffset(typeid(T), offset));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline T& ComponentRef<T>::operator*() {
+	return *static_cast<T*>(GetComponentByOffset(typeid(T), offset));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline Entity ComponentRef<T>::GetEntity() const {
+	return entity;
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline bool ComponentRef<T>::Revalidate() {
+	if (GetEntityGeneration(entity.GetId()) != generation) return false;
+	if (!HasComponent(typeid(T), entity.GetId())) return false;
+	offset = GetComponentOffset(typeid(T), entity.GetId());
+	return true;
+}
+
+} // namespace Junia
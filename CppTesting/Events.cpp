@@ -0,0 +1,103 @@
+#include "Events.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace Junia {
+
+/**
+ * @brief The send buffer slots that are not used by a thread
+*/
+struct EventThreadSlots {
+	std::mutex mutex{ };
+	std::vector<size_t> free{ };
+	size_t next = 0;
+};
+
+static EventThreadSlots& GetEventThreadSlots() {
+	static EventThreadSlots slots{ };
+	return slots;
+}
+
+/**
+ * @brief Holds the slot of a thread and returns it when the thread exits
+*/
+class EventThreadSlot {
+private:
+	size_t slot = 0;
+
+public:
+	EventThreadSlot() {
+		EventThreadSlots& slots = GetEventThreadSlots();
+		const std::lock_guard<std::mutex> lock(slots.mutex);
+		if (!slots.free.empty()) {
+			slot = slots.free.back();
+			slots.free.pop_back();
+			return;
+		}
+		// the overflow slot is shared, it is never handed out as free
+		slot = slots.next == EVENT_THREAD_SLOTS ? EVENT_THREAD_SLOTS : slots.next++;
+	}
+
+	~EventThreadSlot() {
+		if (slot == EVENT_THREAD_SLOTS) return;
+		EventThreadSlots& slots = GetEventThreadSlots();
+		const std::lock_guard<std::mutex> lock(slots.mutex);
+		slots.free.push_back(slot);
+	}
+
+	EventThreadSlot(const EventThreadSlot&) = delete;
+	EventThreadSlot(EventThreadSlot&&) = delete;
+	EventThreadSlot& operator=(const EventThreadSlot&) = delete;
+	EventThreadSlot& operator=(EventThreadSlot&&) = delete;
+
+	[[nodiscard]] size_t Get() const {
+		return slot;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Global functions -----------------------------
+// -----------------------------------------------------------------------------
+
+size_t GetEventThreadSlot() {
+	// the lock is only taken once per thread, sending itself never locks
+	thread_local const EventThreadSlot slot{ };
+	return slot.Get();
+}
+
+void RegisterEventChannel(const std::shared_ptr<EventChannelBase>& channel) {
+	World::GetActiveWorld().RegisterEventChannel(channel);
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+void* EventArena::Allocate(size_t size, size_t alignment) {
+	while (block < blocks.size()) {
+		const size_t start = (offset + alignment - 1) / alignment * alignment;
+		if (start + size <= blockSizes[block]) {
+			offset = start + size;
+			return blocks[block].get() + start;
+		}
+		block++;
+		offset = 0;
+	}
+
+	// new blocks start aligned (operator new[] aligns to max_align_t)
+	const size_t blockSize = std::max(EVENT_ARENA_BLOCK_SIZE, size);
+	blocks.push_back(std::make_unique<std::byte[]>(blockSize));
+	blockSizes.push_back(blockSize);
+	block = blocks.size() - 1;
+	offset = size;
+	return blocks[block].get();
+}
+
+void EventArena::Reset() {
+	block = 0;
+	offset = 0;
+}
+
+} // namespace Junia
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+#ifndef JUNIA_EVENT_THREAD_SLOTS
+#define JUNIA_EVENT_THREAD_SLOTS 64
+#endif
+
+/**
+ * @brief The amount of threads that can send events at the same time without
+ *        locking (further threads share a locked slot, set through the
+ *        JUNIA_EVENT_THREAD_SLOTS definition)
+*/
+constexpr size_t EVENT_THREAD_SLOTS = JUNIA_EVENT_THREAD_SLOTS;
+
+/**
+ * @brief Size of the blocks event arenas allocate (larger events get a block
+ *        of their own size)
+*/
+constexpr size_t EVENT_ARENA_BLOCK_SIZE = 65536;
+
+/**
+ * @brief Alignment of the per thread send buffers (avoids false sharing)
+*/
+constexpr size_t EVENT_CACHE_LINE_SIZE = 64;
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A bump allocator whose memory is reused after a reset instead of
+ *        being freed
+*/
+class EventArena {
+private:
+	std::vector<std::unique_ptr<std::byte[]>> blocks{ };
+	std::vector<size_t> blockSizes{ };
+	size_t block = 0;
+	size_t offset = 0;
+
+public:
+	/**
+	 * @brief Allocate memory that stays valid until the next reset
+	 * @param size The size in bytes
+	 * @param alignment The alignment in bytes (at most
+	 *                  alignof(std::max_align_t))
+	 * @return A pointer to the memory
+	*/
+	void* Allocate(size_t size, size_t alignment);
+
+	/**
+	 * @brief Make all memory available again (keeps the blocks)
+	*/
+	void Reset();
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Get the send buffer slot of the calling thread
+ *        (slots are reused after a thread exits, threads started while all
+ *        slots are taken share the overflow slot EVENT_THREAD_SLOTS)
+ * @return The index of the slot
+*/
+size_t GetEventThreadSlot();
+
+/**
+ * @brief INTERNAL USE ONLY - An event channel as seen by the world
+*/
+class EventChannelBase {
+public:
+	EventChannelBase() = default;
+	virtual ~EventChannelBase() = default;
+	EventChannelBase(const EventChannelBase&) = delete;
+	EventChannelBase(EventChannelBase&&) = delete;
+
+	EventChannelBase& operator=(const EventChannelBase&) = delete;
+	EventChannelBase& operator=(EventChannelBase&&) = delete;
+
+	/**
+	 * @brief Called by World::EndFrame(), drops the events of the previous
+	 *        frame
+	*/
+	virtual void OnEndFrame() = 0;
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Make World::EndFrame() of the active world
+ *        update a channel (until it is destroyed)
+ * @param channel The channel
+*/
+void RegisterEventChannel(const std::shared_ptr<EventChannelBase>& channel);
+
+/**
+ * @brief INTERNAL USE ONLY - The events of one type sent during the current
+ *        and the previous frame
+ * @tparam T The type of the events
+*/
+template<typename T>
+class EventChannel : public EventChannelBase {
+private:
+	static_assert(alignof(T) <= alignof(std::max_align_t),
+		"events must not be aligned beyond the arena alignment (std::max_align_t)");
+
+	/**
+	 * @brief The events a thread has sent since the last merge, allocated
+	 *        from one arena per frame
+	*/
+	struct alignas(EVENT_CACHE_LINE_SIZE) ThreadBuffer {
+		std::array<EventArena, 2> arenas{ };
+		std::vector<T*> pending{ };
+	};
+
+	std::array<ThreadBuffer, EVENT_THREAD_SLOTS + 1> threads{ };
+
+	/**
+	 * @brief Guards the overflow slot (the last one), which is shared by all
+	 *        threads that did not get a slot of their own
+	*/
+	std::mutex overflowMutex{ };
+
+	/**
+	 * @brief The merged events of both frames, the global index of their
+	 *        first event and which of the two is the current frame
+	*/
+	std::array<std::vector<T*>, 2> events{ };
+	std::array<uint64_t, 2> firstIndices{ };
+	size_t current = 0;
+
+	void Merge();
+	void Drop(size_t frame);
+
+	template<typename... TArgs>
+	void Append(ThreadBuffer& buffer, TArgs&&... args);
+
+public:
+	EventChannel() = default;
+	~EventChannel() override;
+	EventChannel(const EventChannel&) = delete;
+	EventChannel(EventChannel&&) = delete;
+
+	EventChannel& operator=(const EventChannel&) = delete;
+	EventChannel& operator=(EventChannel&&) = delete;
+
+	template<typename... TArgs>
+	void Send(TArgs&&... args);
+
+	/**
+	 * @brief Call a function for every available event from a global index
+	 *        on (older ones first)
+	 * @param cursor The global index of the first event to visit
+	 * @param function The function to call with each event
+	 * @return The global index after the last event
+	*/
+	template<typename TFunc>
+	uint64_t ForEachSince(uint64_t cursor, TFunc&& function);
+
+	[[nodiscard]] uint64_t GetOldestIndex() const;
+
+	void OnEndFrame() override;
+};
+
+/**
+ * @brief Reads the events of a channel, every reader has its own cursor
+ * @tparam T The type of the events
+*/
+template<typename T>
+class EventReader {
+private:
+	std::shared_ptr<EventChannel<T>> channel;
+	uint64_t cursor;
+
+public:
+	explicit EventReader(std::shared_ptr<EventChannel<T>> channel);
+
+	/**
+	 * @brief Call a function for every event this reader has not read yet
+	 *        (events are available during the frame they have been sent in
+	 *        and the next one, readers falling further behind miss events).
+	 *        Must not run while events are being sent.
+	 * @tparam TFunc The type of the function
+	 * @param function A function taking a const reference to an event
+	*/
+	template<typename TFunc>
+	void Read(TFunc&& function);
+};
+
+/**
+ * @brief A channel of events of type T of the active world (at creation).
+ *        Events live in per frame arenas that are reset, not freed, by
+ *        World::EndFrame() two frames after they have been sent. Events can
+ *        be sent from many threads at once (each thread appends to its own
+ *        buffer, threads beyond EVENT_THREAD_SLOTS to a shared locked one, the
+ *        buffers are merged when reading), but not while they are being read
+ *        or the frame ends.
+ * @tparam T The type of the events
+*/
+template<typename T>
+class Events {
+private:
+	std::shared_ptr<EventChannel<T>> channel;
+
+public:
+	/**
+	 * @brief Create a channel and register it with the active world
+	*/
+	Events();
+
+	Events(const Events&) = delete;
+	Events(Events&&) noexcept = default;
+	~Events() = default;
+
+	Events& operator=(const Events&) = delete;
+	Events& operator=(Events&&) noexcept = default;
+
+	/**
+	 * @brief Send an event (thread safe with respect to other senders)
+	 * @tparam ...TArgs The types of the parameters to pass to the event
+	 *                  constructor
+	 * @param ...args The parameters to pass to the event constructor
+	*/
+	template<typename... TArgs>
+	void Send(TArgs&&... args);
+
+	/**
+	 * @brief Create a reader starting at the oldest available event
+	 * @return The reader
+	*/
+	[[nodiscard]] EventReader<T> CreateReader() const;
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// ------------------------------ EventChannel<T> ------------------------------
+
+template<typename T>
+inline EventChannel<T>::~EventChannel() {
+	Merge();
+	Drop(0);
+	Drop(1);
+}
+
+template<typename T>
+inline void EventChannel<T>::Merge() {
+	for (ThreadBuffer& buffer : threads) {
+		if (buffer.pending.empty()) continue;
+		events[current].insert(events[current].end(), buffer.pending.begin(), buffer.pending.end());
+		buffer.pending.clear();
+	}
+}
+
+template<typename T>
+inline void EventChannel<T>::Drop(size_t frame) {
+	if constexpr (!std::is_trivially_destructible_v<T>) {
+		for (T* event : events[frame]) std::destroy_at(event);
+	}
+	events[frame].clear();
+	for (ThreadBuffer& buffer : threads) buffer.arenas[frame].Reset();
+}
+
+template<typename T>
+template<typename... TArgs>
+inline void EventChannel<T>::Append(ThreadBuffer& buffer, TArgs&&... args) {
+	void* memory = buffer.arenas[current].Allocate(sizeof(T), alignof(T));
+	buffer.pending.push_back(std::construct_at(static_cast<T*>(memory), std::forward<TArgs>(args)...));
+}
+
+template<typename T>
+template<typename... TArgs>
+inline void EventChannel<T>::Send(TArgs&&... args) {
+	const size_t slot = GetEventThreadSlot();
+	if (slot == EVENT_THREAD_SLOTS) {
+		const std::lock_guard<std::mutex> lock(overflowMutex);
+		Append(threads[slot], std::forward<TArgs>(args)...);
+		return;
+	}
+	Append(threads[slot], std::forward<TArgs>(args)...);
+}
+
+template<typename T>
+template<typename TFunc>
+inline uint64_t EventChannel<T>::ForEachSince(uint64_t cursor, TFunc&& function) {
+	Merge();
+	for (const size_t frame : { 1 - current, current }) {
+		const uint64_t first = firstIndices[frame];
+		for (uint64_t i = cursor > first ? cursor - first : 0; i < events[frame].size(); i++)
+			function(static_cast<const T&>(*events[frame][i]));
+	}
+	return firstIndices[current] + events[current].size();
+}
+
+template<typename T>
+inline uint64_t EventChannel<T>::GetOldestIndex() const {
+	return firstIndices[1 - current];
+}
+
+template<typename T>
+inline void EventChannel<T>::OnEndFrame() {
+	Merge();
+	const size_t next = 1 - current;
+	Drop(next);
+	firstIndices[next] = firstIndices[current] + events[current].size();
+	current = next;
+}
+
+// ------------------------------ EventReader<T> -------------------------------
+
+template<typename T>
+inline EventReader<T>::EventReader(std::shared_ptr<EventChannel<T>> channel)
+	: channel(std::move(channel)), cursor(this->channel->GetOldestIndex()) { }
+
+template<typename T>
+template<typename TFunc>
+inline void EventReader<T>::Read(TFunc&& function) {
+	cursor = channel->ForEachSince(cursor, std::forward<TFunc>(function));
+}
+
+// --------------------------------- Events<T> ---------------------------------
+
+template<typename T>
+inline Events<T>::Events()
+	: channel(std::make_shared<EventChannel<T>>()) {
+	RegisterEventChannel(channel);
+}
+
+template<typename T>
+template<typename... TArgs>
+inline void Events<T>::Send(TArgs&&... args) {
+	channel->Send(std::forward<TArgs>(args)...);
+}
+
+template<typename T>
+inline EventReader<T> Events<T>::CreateReader() const {
+	return EventReader<T>(channel);
+}
+
+} // namespace Junia
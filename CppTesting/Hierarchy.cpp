@@ -0,0 +1,143 @@
+#include "Hierarchy.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Global functions -----------------------------
+// -----------------------------------------------------------------------------
+
+const HierarchyOrder& GetHierarchyOrder() {
+	return World::GetActiveWorld().GetHierarchy().GetOrder();
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+void Hierarchy::Detach(EntityIdType child) {
+	auto iterator = nodes.find(child);
+	if (iterator == nodes.end() || !iterator->second.hasParent) return;
+	const EntityIdType parent = iterator->second.parent;
+	iterator->second.hasParent = false;
+	std::vector<EntityIdType>& siblings = nodes.at(parent).children;
+	siblings.erase(std::find(siblings.begin(), siblings.end(), child));
+	EraseIfUnused(parent);
+	orderDirty = true;
+}
+
+void Hierarchy::EraseIfUnused(EntityIdType entity) {
+	auto iterator = nodes.find(entity);
+	if (iterator != nodes.end() && !iterator->second.hasParent && iterator->second.children.empty())
+		nodes.erase(iterator);
+}
+
+void Hierarchy::SetParent(EntityIdType child, EntityIdType parent) {
+	for (EntityIdType ancestor = parent;;) {
+		if (ancestor == child) throw std::runtime_error("parent would become a descendant of its child");
+		auto iterator = nodes.find(ancestor);
+		if (iterator == nodes.end() || !iterator->second.hasParent) break;
+		ancestor = iterator->second.parent;
+	}
+
+	Detach(child);
+	Node& node = nodes[child];
+	node.parent = parent;
+	node.hasParent = true;
+	nodes[parent].children.push_back(child);
+	orderDirty = true;
+}
+
+void Hierarchy::RemoveParent(EntityIdType child) {
+	Detach(child);
+	EraseIfUnused(child);
+}
+
+bool Hierarchy::HasParent(EntityIdType child) const {
+	auto iterator = nodes.find(child);
+	return iterator != nodes.end() && iterator->second.hasParent;
+}
+
+EntityIdType Hierarchy::GetParent(EntityIdType child) const {
+	auto iterator = nodes.find(child);
+	if (iterator == nodes.end() || !iterator->second.hasParent)
+		throw std::runtime_error("entity has no parent");
+	return iterator->second.parent;
+}
+
+const std::vector<EntityIdType>& Hierarchy::GetChildren(EntityIdType entity) const {
+	static const std::vector<EntityIdType> noChildren{ };
+	auto iterator = nodes.find(entity);
+	return iterator == nodes.end() ? noChildren : iterator->second.children;
+}
+
+std::vector<EntityIdType> Hierarchy::RemoveSubtree(EntityIdType entity) {
+	std::vector<EntityIdType> subtree{ entity };
+	if (!nodes.contains(entity)) return subtree;
+
+	Detach(entity);
+	for (size_t i = 0; i < subtree.size(); i++) {
+		auto iterator = nodes.find(subtree[i]);
+		subtree.insert(subtree.end(), iterator->second.children.begin(), iterator->second.children.end());
+		nodes.erase(iterator);
+	}
+	orderDirty = true;
+	return subtree;
+}
+
+const HierarchyOrder& Hierarchy::GetOrder() {
+	if (!orderDirty) return order;
+
+	order.entities.clear();
+	order.parents.clear();
+	order.depths.clear();
+	order.entities.reserve(nodes.size());
+	order.parents.reserve(nodes.size());
+	order.depths.reserve(nodes.size());
+
+	// breadth first from the roots yields the entities sorted by depth
+	for (const auto& nodePair : nodes) {
+		if (nodePair.second.hasParent) continue;
+		order.entities.push_back(nodePair.first);
+		order.parents.push_back(HIERARCHY_NO_PARENT);
+		order.depths.push_back(0);
+	}
+	std::sort(order.entities.begin(), order.entities.end());
+	for (size_t i = 0; i < order.entities.size(); i++) {
+		for (const EntityIdType child : nodes.at(order.entities[i]).children) {
+			order.entities.push_back(child);
+			order.parents.push_back(i);
+			order.depths.push_back(order.depths[i] + 1);
+		}
+	}
+
+	orderDirty = false;
+	return order;
+}
+
+void Hierarchy::GetRelationships(std::vector<EntityIdType>& children,
+	std::vector<EntityIdType>& parents) const {
+	children.clear();
+	parents.clear();
+	// grouped by parent with the children in order, so that restoring them
+	// one after another rebuilds the same child lists
+	for (const auto& nodePair : nodes) {
+		for (const EntityIdType child : nodePair.second.children) {
+			children.push_back(child);
+			parents.push_back(nodePair.first);
+		}
+	}
+}
+
+void Hierarchy::Restore(const std::vector<EntityIdType>& children,
+	const std::vector<EntityIdType>& parents) {
+	if (children.size() != parents.size()) throw std::runtime_error("corrupted hierarchy");
+	nodes.clear();
+	orderDirty = true;
+	for (size_t i = 0; i < children.size(); i++) SetParent(children[i], parents[i]);
+}
+
+} // namespace Junia
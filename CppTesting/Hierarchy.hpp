@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ECS.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief Marks entities without a parent in HierarchyOrder::parents
+*/
+constexpr size_t HIERARCHY_NO_PARENT = std::numeric_limits<size_t>::max();
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief All entities with a parent or children as parallel arrays sorted by
+ *        depth, so every parent comes before its children
+*/
+struct HierarchyOrder {
+	std::vector<EntityIdType> entities{ };
+
+	/**
+	 * @brief The index of the parent of each entity in entities (or
+	 *        HIERARCHY_NO_PARENT for roots)
+	*/
+	std::vector<size_t> parents{ };
+
+	std::vector<uint32_t> depths{ };
+};
+
+/**
+ * @brief INTERNAL USE ONLY - The parent/child relationships of the entities
+ *        of a world
+*/
+class Hierarchy {
+private:
+	/**
+	 * @brief The relationships of an entity with a parent or children
+	*/
+	struct Node {
+		EntityIdType parent = 0;
+		bool hasParent = false;
+		std::vector<EntityIdType> children{ };
+	};
+
+	std::unordered_map<EntityIdType, Node> nodes{ };
+	HierarchyOrder order{ };
+	bool orderDirty = false;
+
+	void Detach(EntityIdType child);
+	void EraseIfUnused(EntityIdType entity);
+
+public:
+	void SetParent(EntityIdType child, EntityIdType parent);
+	void RemoveParent(EntityIdType child);
+	[[nodiscard]] bool HasParent(EntityIdType child) const;
+	[[nodiscard]] EntityIdType GetParent(EntityIdType child) const;
+	[[nodiscard]] const std::vector<EntityIdType>& GetChildren(EntityIdType entity) const;
+
+	/**
+	 * @brief Remove an entity and all of its descendants from the hierarchy
+	 * @param entity The root of the subtree to remove
+	 * @return The entity followed by its descendants (parents before
+	 *         children)
+	*/
+	std::vector<EntityIdType> RemoveSubtree(EntityIdType entity);
+
+	const HierarchyOrder& GetOrder();
+
+	/**
+	 * @brief Get all relationships as parallel arrays (for snapshots)
+	 * @param children Receives the children, grouped by parent in the order
+	 *                 of Hierarchy::GetChildren()
+	 * @param parents Receives the parent of each child
+	*/
+	void GetRelationships(std::vector<EntityIdType>& children, std::vector<EntityIdType>& parents) const;
+
+	/**
+	 * @brief Replace all relationships by ones from
+	 *        Hierarchy::GetRelationships() (children keep their order)
+	 * @param children The children
+	 * @param parents The parent of each child
+	*/
+	void Restore(const std::vector<EntityIdType>& children, const std::vector<EntityIdType>& parents);
+};
+
+/**
+ * @brief Get the entities of the active world that have a parent or children
+ *        ordered by depth. Propagating values from parents to children (e.g.
+ *        transforms) is a single pass over the arrays that reads the already
+ *        updated parent by its index. The order is rebuilt on the first call
+ *        after the hierarchy changed, the reference stays valid until then.
+ * @return The depth sorted entities and the indices of their parents
+*/
+const HierarchyOrder& GetHierarchyOrder();
+
+} // namespace Junia
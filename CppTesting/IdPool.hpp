@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Stats.hpp"
+
+#include <climits>
 #include <cstdint>
 #include <stack>
+#include <stdexcept>
 #include <vector>
 
 namespace Junia {
@@ -25,6 +29,13 @@ public:
 	 *         of
 	*/
 	std::vector<T>& GetContainer();
+
+	/**
+	 * @brief Get the underlying container
+	 * @return a const reference to the container the stack has been built on
+	 *         top of
+	*/
+	const std::vector<T>& GetContainer() const;
 };
 
 /**
@@ -35,10 +46,22 @@ template<typename T>
 class IdPool {
 private:
 	IdPoolStackAdapter<T> freeIds{ };
+
+	/**
+	 * @brief Whether each ID below current is in freeIds (by the index of the
+	 *        ID, (id - start) / step)
+	*/
+	std::vector<bool> freeFlags{ };
+
 	T start;
 	T current;
 	T step;
 
+#ifdef JUNIA_ECS_STATS
+	uint64_t nextCalls = 0;
+	uint64_t freeCalls = 0;
+#endif
+
 public:
 	/**
 	 * @brief Create a new ID pool
@@ -57,12 +80,49 @@ public:
 	T Next();
 
 	/**
-	 * @brief Return an ID to the pool (unchecked).
-	 * @param id the ID to put back into the pool. In order to maintain
-	 *           uniqueness of IDs only pass IDs that have been returned by
-	 *           the IdPool::Next() function of this IdPool
+	 * @brief Return an ID to the pool (throws std::runtime_error if the ID is
+	 *        not in use, freeing it twice would hand it out twice)
+	 * @param poolId the ID to put back into the pool
 	*/
 	void Free(T poolId);
+
+	/**
+	 * @brief Check whether an ID is in use
+	 * @param poolId the ID to check
+	 * @return true if the ID has been returned by IdPool::Next() and has not
+	 *         been freed since
+	*/
+	bool IsUsed(T poolId) const;
+
+	/**
+	 * @brief Get the next ID that will be handed out once all freed IDs have
+	 *        been reused
+	 * @return the current upper bound of the pool
+	*/
+	T GetCurrent() const;
+
+	/**
+	 * @brief Get the IDs that have been returned to the pool
+	 * @return the freed IDs in the order they have been returned
+	*/
+	const std::vector<T>& GetFreeIds() const;
+
+	/**
+	 * @brief Restore a state previously queried through IdPool::GetCurrent()
+	 *        and IdPool::GetFreeIds() (throws std::runtime_error and leaves
+	 *        the pool unchanged if the freed IDs could not have been handed
+	 *        out or contain duplicates)
+	 * @param current the next ID to hand out once all freed IDs are used up
+	 * @param freed the IDs that have been returned to the pool
+	*/
+	void Restore(T current, std::vector<T> freed);
+
+	/**
+	 * @brief Get the statistics of the pool (the call counters are only
+	 *        counted if JUNIA_ECS_STATS is defined)
+	 * @return the current statistics
+	*/
+	IdPoolStats GetStats() const;
 };
 
 // -----------------------------------------------------------------------------
@@ -74,6 +134,11 @@ inline std::vector<T>& Junia::IdPoolStackAdapter<T>::GetContainer() {
 	return this->c;
 }
 
+template<typename T>
+inline const std::vector<T>& Junia::IdPoolStackAdapter<T>::GetContainer() const {
+	return this->c;
+}
+
 template<typename T>
 inline Junia::IdPool<T>::IdPool(T start, T step, size_t reservedFrees)
 	: start(start), current(start), step(step) {
@@ -82,6 +147,9 @@ inline Junia::IdPool<T>::IdPool(T start, T step, size_t reservedFrees)
 
 template<typename T>
 inline T Junia::IdPool<T>::Next() {
+#ifdef JUNIA_ECS_STATS
+	nextCalls++;
+#endif
 	T poolId{ };
 	if (freeIds.empty()) {
 		poolId = current;
@@ -90,14 +158,74 @@ inline T Junia::IdPool<T>::Next() {
 	}
 	poolId = freeIds.top();
 	freeIds.pop();
+	freeFlags[static_cast<size_t>((poolId - start) / step)] = false;
 	return poolId;
 }
 
 template<typename T>
 inline void IdPool<T>::Free(T poolId) {
-	if (poolId == current - step)
+	if (!IsUsed(poolId)) throw std::runtime_error("ID is not in use");
+#ifdef JUNIA_ECS_STATS
+	freeCalls++;
+#endif
+	if (poolId == current - step) {
 		current = current - step;
-	else freeIds.push(poolId);
+		return;
+	}
+	freeIds.push(poolId);
+	const auto index = static_cast<size_t>((poolId - start) / step);
+	if (index >= freeFlags.size()) freeFlags.resize(index + 1);
+	freeFlags[index] = true;
+}
+
+template<typename T>
+inline bool IdPool<T>::IsUsed(T poolId) const {
+	if (poolId < start || poolId >= current || (poolId - start) % step != 0) return false;
+	const auto index = static_cast<size_t>((poolId - start) / step);
+	return index >= freeFlags.size() || !freeFlags[index];
+}
+
+template<typename T>
+inline T IdPool<T>::GetCurrent() const {
+	return current;
+}
+
+template<typename T>
+inline const std::vector<T>& IdPool<T>::GetFreeIds() const {
+	return freeIds.GetContainer();
+}
+
+template<typename T>
+inline void IdPool<T>::Restore(T current, std::vector<T> freed) {
+	if (current < start || (current - start) % step != 0)
+		throw std::runtime_error("invalid ID pool state");
+	std::vector<bool> flags(static_cast<size_t>((current - start) / step), false);
+	for (const T poolId : freed) {
+		if (poolId < start || poolId >= current || (poolId - start) % step != 0)
+			throw std::runtime_error("invalid ID pool state");
+		const auto index = static_cast<size_t>((poolId - start) / step);
+		if (flags[index]) throw std::runtime_error("invalid ID pool state");
+		flags[index] = true;
+	}
+
+	this->current = current;
+	freeIds.GetContainer() = std::move(freed);
+	freeFlags = std::move(flags);
+}
+
+template<typename T>
+inline IdPoolStats IdPool<T>::GetStats() const {
+	IdPoolStats stats{ };
+	const std::vector<T>& freed = freeIds.GetContainer();
+	stats.freeCount = freed.size();
+	stats.liveCount = static_cast<size_t>((current - start) / step) - freed.size();
+	stats.freeCapacity = freed.capacity();
+	stats.bytesAllocated = (freed.capacity() * sizeof(T)) + (freeFlags.capacity() / CHAR_BIT);
+#ifdef JUNIA_ECS_STATS
+	stats.nextCalls = nextCalls;
+	stats.freeCalls = freeCalls;
+#endif
+	return stats;
 }
 
 } // namespace Junia
@@ -0,0 +1,77 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Junia {
+
+#ifdef _WIN32
+
+MappedFile MappedFile::Open(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("failed to open " + path);
+
+	LARGE_INTEGER fileSize{ };
+	if (GetFileSizeEx(file, &fileSize) == 0 || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		throw std::runtime_error("failed to map " + path);
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		throw std::runtime_error("failed to map " + path);
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == nullptr)
+		throw std::runtime_error("failed to map " + path);
+
+	MappedFile mappedFile{ };
+	mappedFile.size = static_cast<size_t>(fileSize.QuadPart);
+	mappedFile.data = std::shared_ptr<uint8_t>(static_cast<uint8_t*>(view),
+		[](const uint8_t* ptr) -> void { UnmapViewOfFile(ptr); });
+	return mappedFile;
+}
+
+#else
+
+MappedFile MappedFile::Open(const std::string& path) {
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		throw std::runtime_error("failed to open " + path);
+
+	struct stat fileStat { };
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+		close(file);
+		throw std::runtime_error("failed to map " + path);
+	}
+
+	const auto size = static_cast<size_t>(fileStat.st_size);
+	void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+		throw std::runtime_error("failed to map " + path);
+
+	MappedFile mappedFile{ };
+	mappedFile.size = size;
+	mappedFile.data = std::shared_ptr<uint8_t>(static_cast<uint8_t*>(view),
+		[size](uint8_t* ptr) -> void { munmap(ptr, size); });
+	return mappedFile;
+}
+
+#endif
+
+} // namespace Junia
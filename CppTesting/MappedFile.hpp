@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Junia {
+
+/**
+ * @brief A file mapped into memory copy-on-write: pages are shared with the
+ *        page cache (and every other process mapping the same file) until
+ *        they are written to, writes are never carried back to the file
+*/
+struct MappedFile {
+	/**
+	 * @brief The first byte of the mapping (unmapped when the last reference
+	 *        is released, aliasing pointers keep the mapping alive as well)
+	*/
+	std::shared_ptr<uint8_t> data = nullptr;
+
+	/**
+	 * @brief The size of the mapping in bytes
+	*/
+	size_t size = 0;
+
+	/**
+	 * @brief Map a file (throws std::runtime_error on failure)
+	 * @param path The path of the file to map
+	 * @return The mapped file
+	*/
+	static MappedFile Open(const std::string& path);
+};
+
+} // namespace Junia
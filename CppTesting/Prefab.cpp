@@ -0,0 +1,29 @@
+#include "Prefab.hpp"
+
+namespace Junia {
+
+Entity Prefab::Instantiate() const {
+	return Instantiate(1).front();
+}
+
+std::vector<Entity> Prefab::Instantiate(size_t count) const {
+	std::vector<Entity> entities{ };
+	std::vector<EntityIdType> entityIds{ };
+	entities.reserve(count);
+	entityIds.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		entities.push_back(Entity::Create());
+		entityIds.push_back(entities.back().GetId());
+	}
+
+	try {
+		for (const auto& component : components)
+			AddComponents(component.type, entityIds, component.construct);
+	} catch (...) {
+		for (const Entity entity : entities) Entity::DestroyEntity(entity);
+		throw;
+	}
+	return entities;
+}
+
+} // namespace Junia
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ECS.hpp"
+
+#include <memory>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A set of components with initial values that can be instantiated
+ *        many times
+*/
+class Prefab {
+private:
+	/**
+	 * @brief A component type with the function stamping out copies of its
+	 *        initial value
+	*/
+	struct ComponentPrototype {
+		std::type_index type;
+		BatchConstructorFunc construct;
+	};
+
+	std::vector<ComponentPrototype> components{ };
+
+public:
+	/**
+	 * @brief Add a component to the prefab (replaces an already added
+	 *        component of the same type)
+	 * @tparam T The type of the component to add
+	 * @tparam ...TArgs The types of the parameters to pass to the component
+	 *                  constructor
+	 * @param ...args The parameters to pass to the component constructor
+	 * @return A reference to this prefab
+	*/
+	template<TypenameDerivedFrom<Component> T, typename... TArgs>
+	Prefab& AddComponent(TArgs&&... args);
+
+	/**
+	 * @brief Create an entity with copies of the prefab components
+	 * @return The created entity
+	*/
+	[[nodiscard]] Entity Instantiate() const;
+
+	/**
+	 * @brief Create entities with copies of the prefab components. Every
+	 *        component type is looked up once and its components are copy
+	 *        constructed into runs of consecutive slots (filling holes first).
+	 *        If a copy throws, the created entities are destroyed again.
+	 * @param count The amount of entities to create
+	 * @return The created entities
+	*/
+	[[nodiscard]] std::vector<Entity> Instantiate(size_t count) const;
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+template<TypenameDerivedFrom<Component> T, typename ...TArgs>
+inline Prefab& Prefab::AddComponent(TArgs&& ...args) {
+	std::shared_ptr<const T> prototype = std::make_shared<const T>(std::forward<TArgs>(args)...);
+	BatchConstructorFunc construct =
+		[prototype](void* destination, size_t count, const EntityIdType* entities) -> void {
+			T* components = static_cast<T*>(destination);
+			size_t constructed = 0;
+			try {
+				for (; constructed < count; constructed++)
+					std::construct_at<T>(components + constructed, *prototype)->SetEntity(entities[constructed]);
+			} catch (...) {
+				std::destroy_n(components, constructed);
+				throw;
+			}
+		};
+
+	for (auto& component : components) {
+		if (component.type != typeid(T)) continue;
+		component.construct = std::move(construct);
+		return *this;
+	}
+	components.push_back({ typeid(T), std::move(construct) });
+	return *this;
+}
+
+} // namespace Junia
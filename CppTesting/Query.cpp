@@ -0,0 +1,110 @@
+#include "Query.hpp"
+#include "ComponentStore.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Global functions -----------------------------
+// -----------------------------------------------------------------------------
+
+std::shared_ptr<QueryCache> CreateQueryCache(std::vector<std::type_index> types) {
+	auto cache = std::make_shared<QueryCache>(std::move(types));
+	World::GetActiveWorld().RegisterQuery(cache);
+	return cache;
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+QueryCache::QueryCache(std::vector<std::type_index> types)
+	: types(std::move(types)) { }
+
+bool QueryCache::Matches(World& world, EntityIdType entity) const {
+	const World::ComponentStoreMapType& stores = world.GetComponentStores();
+	return std::all_of(types.begin(), types.end(), [&stores, entity](std::type_index type) -> bool {
+		auto iterator = stores.find(type);
+		return iterator != stores.end() && iterator->second->HasComponent(entity);
+	});
+}
+
+bool QueryCache::IsEnabled(World& world, EntityIdType entity) const {
+	if (!world.IsEntityEnabled(entity)) return false;
+	const World::ComponentStoreMapType& stores = world.GetComponentStores();
+	return std::all_of(types.begin(), types.end(), [&stores, entity](std::type_index type) -> bool {
+		const ComponentStore& store = *stores.at(type);
+		return !store.HasDisabled() || store.IsEnabled(entity);
+	});
+}
+
+void QueryCache::Insert(World& world, EntityIdType entity) {
+	positions.emplace(entity, entities.size());
+	enabled.Set(entities.size(), IsEnabled(world, entity));
+	entities.push_back(entity);
+}
+
+void QueryCache::Erase(EntityIdType entity) {
+	auto iterator = positions.find(entity);
+	if (iterator == positions.end()) return;
+	const size_t position = iterator->second;
+	const size_t last = entities.size() - 1;
+	positions.erase(iterator);
+	if (position != last) {
+		entities[position] = entities.back();
+		positions[entities[position]] = position;
+		enabled.Set(position, enabled.Test(last));
+	}
+	enabled.Set(last, false);
+	entities.pop_back();
+}
+
+const std::vector<std::type_index>& QueryCache::GetTypes() const {
+	return types;
+}
+
+const std::vector<EntityIdType>& QueryCache::GetEntities() const {
+	return entities;
+}
+
+const Bitset& QueryCache::GetEnabled() const {
+	return enabled;
+}
+
+void QueryCache::OnComponentAdded(World& world, EntityIdType entity) {
+	if (positions.contains(entity) || !Matches(world, entity)) return;
+	Insert(world, entity);
+}
+
+void QueryCache::OnComponentRemoved(EntityIdType entity) {
+	Erase(entity);
+}
+
+void QueryCache::OnEnabledChanged(World& world, EntityIdType entity) {
+	auto iterator = positions.find(entity);
+	if (iterator != positions.end()) enabled.Set(iterator->second, IsEnabled(world, entity));
+}
+
+void QueryCache::Rebuild(World& world) {
+	entities.clear();
+	positions.clear();
+	enabled.Clear();
+
+	// candidates are taken from the smallest store
+	std::shared_ptr<ComponentStore> smallest = nullptr;
+	for (const std::type_index type : types) {
+		auto iterator = world.GetComponentStores().find(type);
+		if (iterator == world.GetComponentStores().end()) return;
+		if (smallest == nullptr || iterator->second->GetCount() < smallest->GetCount())
+			smallest = iterator->second;
+	}
+	if (smallest == nullptr) return;
+
+	for (const EntityIdType entity : smallest->GetEntities()) {
+		if (Matches(world, entity)) Insert(world, entity);
+	}
+}
+
+} // namespace Junia
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Bitset.hpp"
+#include "ECS.hpp"
+
+#include <bit>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+// Forward declaration for use in QueryCache class
+class World;
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief INTERNAL USE ONLY - The entities having all components of a set of
+ *        types, kept up to date by the world the cache is registered with
+*/
+class QueryCache {
+private:
+	std::vector<std::type_index> types;
+
+	/**
+	 * @brief The matching entities (unordered, removal swaps in the last one)
+	*/
+	std::vector<EntityIdType> entities{ };
+
+	/**
+	 * @brief The position of every matching entity in entities
+	*/
+	std::unordered_map<EntityIdType, size_t> positions{ };
+
+	/**
+	 * @brief Which of the matching entities are enabled (by position in
+	 *        entities, set if the entity and all of its components of the
+	 *        query are enabled)
+	*/
+	Bitset enabled{ };
+
+	[[nodiscard]] bool Matches(World& world, EntityIdType entity) const;
+	[[nodiscard]] bool IsEnabled(World& world, EntityIdType entity) const;
+	void Insert(World& world, EntityIdType entity);
+	void Erase(EntityIdType entity);
+
+public:
+	explicit QueryCache(std::vector<std::type_index> types);
+
+	[[nodiscard]] const std::vector<std::type_index>& GetTypes() const;
+	[[nodiscard]] const std::vector<EntityIdType>& GetEntities() const;
+	[[nodiscard]] const Bitset& GetEnabled() const;
+
+	void OnComponentAdded(World& world, EntityIdType entity);
+	void OnComponentRemoved(EntityIdType entity);
+	void OnEnabledChanged(World& world, EntityIdType entity);
+	void Rebuild(World& world);
+};
+
+/**
+ * @brief INTERNAL USE ONLY - Register a query cache with the active world
+ * @param types The component types of the query
+ * @return The cache, already filled with the current matches
+*/
+std::shared_ptr<QueryCache> CreateQueryCache(std::vector<std::type_index> types);
+
+/**
+ * @brief A persistent query for all entities having components of every type
+ *        in T. The matching entities are maintained by the world that was
+ *        active when the query was created as components are added and
+ *        removed, so iterating does not have to search the stores. Only
+ *        iterate while that world is active (forks do not inherit queries).
+ * @tparam ...T The component types an entity needs to match
+*/
+template<TypenameDerivedFrom<Component>... T>
+class Query {
+private:
+	std::shared_ptr<QueryCache> cache;
+
+public:
+	/**
+	 * @brief Create a query and register it with the active world (copies
+	 *        share the registration, it ends with the last copy)
+	*/
+	Query();
+
+	/**
+	 * @brief Get the amount of matching entities (including disabled ones)
+	 * @return The amount of entities having all components
+	*/
+	[[nodiscard]] size_t Size() const;
+
+	/**
+	 * @brief Get the matching entities (in no particular order, including
+	 *        disabled ones)
+	 * @return The ids of all entities having all components
+	*/
+	[[nodiscard]] const std::vector<EntityIdType>& GetEntities() const;
+
+	/**
+	 * @brief Call a function for every matching entity that is enabled and
+	 *        whose components of T are enabled (disabled ones are skipped 64
+	 *        at a time). Components of the current entity may be added or
+	 *        removed by the function, changes to other entities may cause them
+	 *        to be skipped or visited twice.
+	 * @tparam TFunc The type of the function
+	 * @param function A function taking the Entity followed by a reference to
+	 *                 each of its components in the order of T
+	*/
+	template<typename TFunc>
+	void ForEach(TFunc&& function);
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+template<TypenameDerivedFrom<Component>... T>
+inline Query<T...>::Query()
+	: cache(CreateQueryCache({ typeid(T)... })) { }
+
+template<TypenameDerivedFrom<Component>... T>
+inline size_t Query<T...>::Size() const {
+	return cache->GetEntities().size();
+}
+
+template<TypenameDerivedFrom<Component>... T>
+inline const std::vector<EntityIdType>& Query<T...>::GetEntities() const {
+	return cache->GetEntities();
+}
+
+template<TypenameDerivedFrom<Component>... T>
+template<typename TFunc>
+inline void Query<T...>::ForEach(TFunc&& function) {
+	// backwards, so that removing the current entity (swapping in the last
+	// one) does not skip anything
+	const std::vector<EntityIdType>& entities = cache->GetEntities();
+	const Bitset& enabled = cache->GetEnabled();
+	for (size_t word = enabled.GetWords().size(); word-- > 0;) {
+		if (word >= enabled.GetWords().size()) continue;
+		uint64_t bits = enabled.GetWords()[word];
+		while (bits != 0) {
+			const auto bit = static_cast<size_t>(std::bit_width(bits) - 1);
+			bits &= ~(uint64_t{ 1 } << bit);
+			const size_t i = (word * BITSET_WORD_BITS) + bit;
+			if (i >= entities.size() || !enabled.Test(i)) continue;
+			Entity entity = Entity::Get(entities[i]);
+			function(entity, entity.GetComponent<T>()...);
+		}
+	}
+}
+
+} // namespace Junia
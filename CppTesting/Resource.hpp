@@ -0,0 +1,117 @@
+#pragma once
+
+#include "World.hpp"
+
+#include <concepts>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Get the id of a resource type (assigned on first use, the same in
+ *        all worlds)
+ * @tparam T The type of the resource
+ * @return The id indexing the resources of a world
+*/
+template<typename T>
+ResourceIdType GetResourceId();
+
+/**
+ * @brief Set a singleton resource of the active world (e.g. time, input or
+ *        configuration), replacing an existing resource of the same type
+ * @tparam T The type of the resource
+ * @tparam ...TArgs The types of the parameters to pass to the constructor
+ * @param ...args The parameters to pass to the constructor
+ * @return A reference to the resource
+*/
+template<typename T, typename... TArgs>
+T& SetResource(TArgs&&... args);
+
+/**
+ * @brief Remove a resource of the active world (references to it become
+ *        invalid)
+ * @tparam T The type of the resource
+*/
+template<typename T>
+void RemoveResource();
+
+/**
+ * @brief Check whether the active world has a resource
+ * @tparam T The type of the resource
+ * @return true if the resource has been set, false otherwise
+*/
+template<typename T>
+bool HasResource();
+
+/**
+ * @brief Get a resource of the active world for writing (an index into the
+ *        resources of the world, no hashing; throws std::runtime_error if it
+ *        has not been set)
+ * @tparam T The type of the resource
+ * @return A reference to the resource
+*/
+template<typename T>
+T& GetResource();
+
+/**
+ * @brief Get a resource of the active world for reading only (see
+ *        Junia::GetResource())
+ * @tparam T The type of the resource
+ * @return A const reference to the resource
+*/
+template<typename T>
+const T& ReadResource();
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+template<typename T>
+inline ResourceIdType GetResourceId() {
+	static const ResourceIdType id = World::AllocateResourceId();
+	return id;
+}
+
+template<typename T, typename... TArgs>
+inline T& SetResource(TArgs&&... args) {
+	std::shared_ptr<T> resource = std::make_shared<T>(std::forward<TArgs>(args)...);
+	T& reference = *resource;
+	World::ResourceCopyFunc copy = nullptr;
+	if constexpr (std::copy_constructible<T>) {
+		copy = [](const void* ptr) -> std::shared_ptr<void> {
+			return std::make_shared<T>(*static_cast<const T*>(ptr));
+		};
+	}
+	World::GetActiveWorld().SetResource(GetResourceId<T>(), std::move(resource), std::move(copy));
+	return reference;
+}
+
+template<typename T>
+inline void RemoveResource() {
+	World::GetActiveWorld().RemoveResource(GetResourceId<T>());
+}
+
+template<typename T>
+inline bool HasResource() {
+	return World::GetActiveWorld().FindResource(GetResourceId<T>()) != nullptr;
+}
+
+template<typename T>
+inline T& GetResource() {
+	void* resource = World::GetActiveWorld().FindResource(GetResourceId<T>());
+	if (resource == nullptr) throw std::runtime_error("resource has not been set");
+	return *static_cast<T*>(resource);
+}
+
+template<typename T>
+inline const T& ReadResource() {
+	return GetResource<T>();
+}
+
+} // namespace Junia
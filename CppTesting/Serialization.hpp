@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief The most bytes a BinaryReader allocates ahead of the data actually
+ *        read (lengths read from a stream are not trusted)
+*/
+constexpr size_t SERIALIZATION_READ_CHUNK_SIZE = 1048576;
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A read only stream buffer over a block of memory (does not copy or
+ *        own the memory)
+*/
+class MemoryStreamBuffer : public std::streambuf {
+public:
+	MemoryStreamBuffer(const uint8_t* bytes, size_t size);
+};
+
+/**
+ * @brief Writes raw values in native byte order to a stream while keeping
+ *        track of the position (used for aligning bulk data blocks)
+*/
+class BinaryWriter {
+private:
+	std::ostream& stream;
+	size_t position = 0;
+
+public:
+	explicit BinaryWriter(std::ostream& stream);
+
+	/**
+	 * @brief Write a trivially copyable value
+	 * @tparam T The type of the value
+	 * @param value The value to write
+	*/
+	template<typename T>
+	void Write(const T& value);
+
+	/**
+	 * @brief Write all elements of a vector in a single call (prefixed with the
+	 *        element count)
+	 * @tparam T The (trivially copyable) type of the elements
+	 * @param values The values to write
+	*/
+	template<typename T>
+	void WriteVector(const std::vector<T>& values);
+
+	/**
+	 * @brief Write a string (prefixed with its length)
+	 * @param value The string to write
+	*/
+	void WriteString(const std::string& value);
+
+	/**
+	 * @brief Write a block of raw memory
+	 * @param bytes A pointer to the first byte to write
+	 * @param size The amount of bytes to write
+	*/
+	void WriteBytes(const void* bytes, size_t size);
+
+	/**
+	 * @brief Write zero bytes until the position is a multiple of alignment
+	 * @param alignment The alignment in bytes
+	*/
+	void Align(size_t alignment);
+
+	/**
+	 * @brief Get the amount of bytes written so far
+	 * @return The current position relative to the start of the writer
+	*/
+	[[nodiscard]] size_t GetPosition() const;
+};
+
+/**
+ * @brief Reads values written by a BinaryWriter (throws std::runtime_error if
+ *        the stream ends prematurely)
+*/
+class BinaryReader {
+private:
+	std::istream& stream;
+	size_t position = 0;
+
+public:
+	explicit BinaryReader(std::istream& stream);
+
+	/**
+	 * @brief Read a trivially copyable value
+	 * @tparam T The type of the value
+	 * @return The value that has been read
+	*/
+	template<typename T>
+	T Read();
+
+	/**
+	 * @brief Read a vector written by BinaryWriter::WriteVector() (grows in
+	 *        chunks, so a corrupted element count fails at the end of the
+	 *        stream instead of allocating its size up front)
+	 * @tparam T The (trivially copyable) type of the elements
+	 * @return The values that have been read
+	*/
+	template<typename T>
+	std::vector<T> ReadVector();
+
+	/**
+	 * @brief Read a string written by BinaryWriter::WriteString() (grows in
+	 *        chunks like BinaryReader::ReadVector())
+	 * @return The string that has been read
+	*/
+	std::string ReadString();
+
+	/**
+	 * @brief Read a block of raw memory
+	 * @param bytes A pointer to the memory to read into
+	 * @param size The amount of bytes to read
+	*/
+	void ReadBytes(void* bytes, size_t size);
+
+	/**
+	 * @brief Skip a block of memory
+	 * @param size The amount of bytes to skip
+	*/
+	void Skip(size_t size);
+
+	/**
+	 * @brief Skip bytes until the position is a multiple of alignment
+	 * @param alignment The alignment in bytes
+	*/
+	void Align(size_t alignment);
+
+	/**
+	 * @brief Get the amount of bytes read so far
+	 * @return The current position relative to the start of the reader
+	*/
+	[[nodiscard]] size_t GetPosition() const;
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// ----------------------------- MemoryStreamBuffer ----------------------------
+
+inline MemoryStreamBuffer::MemoryStreamBuffer(const uint8_t* bytes, size_t size) {
+	// std::streambuf only takes mutable pointers, the get area is never written
+	char* begin = const_cast<char*>(reinterpret_cast<const char*>(bytes));
+	setg(begin, begin, begin + size);
+}
+
+// -------------------------------- BinaryWriter -------------------------------
+
+inline BinaryWriter::BinaryWriter(std::ostream& stream)
+	: stream(stream) { }
+
+template<typename T>
+inline void BinaryWriter::Write(const T& value) {
+	static_assert(std::is_trivially_copyable_v<T>, "can only write trivially copyable values");
+	WriteBytes(&value, sizeof(T));
+}
+
+template<typename T>
+inline void BinaryWriter::WriteVector(const std::vector<T>& values) {
+	static_assert(std::is_trivially_copyable_v<T>, "can only write trivially copyable values");
+	Write<uint64_t>(values.size());
+	WriteBytes(values.data(), values.size() * sizeof(T));
+}
+
+inline void BinaryWriter::WriteString(const std::string& value) {
+	Write<uint64_t>(value.size());
+	WriteBytes(value.data(), value.size());
+}
+
+inline void BinaryWriter::WriteBytes(const void* bytes, size_t size) {
+	if (size == 0) return;
+	stream.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+	if (!stream) throw std::runtime_error("failed to write to stream");
+	position += size;
+}
+
+inline void BinaryWriter::Align(size_t alignment) {
+	static constexpr char padding[64]{ };
+	size_t remaining = (alignment - (position % alignment)) % alignment;
+	while (remaining > 0) {
+		const size_t chunk = remaining < sizeof(padding) ? remaining : sizeof(padding);
+		WriteBytes(padding, chunk);
+		remaining -= chunk;
+	}
+}
+
+inline size_t BinaryWriter::GetPosition() const {
+	return position;
+}
+
+// -------------------------------- BinaryReader -------------------------------
+
+inline BinaryReader::BinaryReader(std::istream& stream)
+	: stream(stream) { }
+
+template<typename T>
+inline T BinaryReader::Read() {
+	static_assert(std::is_trivially_copyable_v<T>, "can only read trivially copyable values");
+	T value{ };
+	ReadBytes(&value, sizeof(T));
+	return value;
+}
+
+template<typename T>
+inline std::vector<T> BinaryReader::ReadVector() {
+	static_assert(std::is_trivially_copyable_v<T>, "can only read trivially copyable values");
+	constexpr uint64_t chunk = std::max<uint64_t>(1, SERIALIZATION_READ_CHUNK_SIZE / sizeof(T));
+	std::vector<T> values{ };
+	for (uint64_t remaining = Read<uint64_t>(); remaining > 0;) {
+		const size_t offset = values.size();
+		const auto length = static_cast<size_t>(std::min(remaining, chunk));
+		values.resize(offset + length);
+		ReadBytes(values.data() + offset, length * sizeof(T));
+		remaining -= length;
+	}
+	return values;
+}
+
+inline std::string BinaryReader::ReadString() {
+	std::string value{ };
+	for (uint64_t remaining = Read<uint64_t>(); remaining > 0;) {
+		const size_t offset = value.size();
+		const auto length = static_cast<size_t>(std::min<uint64_t>(remaining, SERIALIZATION_READ_CHUNK_SIZE));
+		value.resize(offset + length);
+		ReadBytes(value.data() + offset, length);
+		remaining -= length;
+	}
+	return value;
+}
+
+inline void BinaryReader::ReadBytes(void* bytes, size_t size) {
+	if (size == 0) return;
+	stream.read(static_cast<char*>(bytes), static_cast<std::streamsize>(size));
+	if (!stream) throw std::runtime_error("unexpected end of stream");
+	position += size;
+}
+
+inline void BinaryReader::Skip(size_t size) {
+	if (size == 0) return;
+	stream.ignore(static_cast<std::streamsize>(size));
+	if (!stream || static_cast<size_t>(stream.gcount()) != size)
+		throw std::runtime_error("unexpected end of stream");
+	position += size;
+}
+
+inline void BinaryReader::Align(size_t alignment) {
+	Skip((alignment - (position % alignment)) % alignment);
+}
+
+inline size_t BinaryReader::GetPosition() const {
+	return position;
+}
+
+} // namespace Junia
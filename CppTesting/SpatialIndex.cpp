@@ -0,0 +1,193 @@
+#include "SpatialIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Junia {
+
+/**
+ * @brief Bits per axis of a packed cell key (three axes share 64 bits)
+*/
+constexpr int SPATIAL_CELL_BITS = 21;
+
+/**
+ * @brief Cell coordinates are clamped to [-SPATIAL_CELL_LIMIT,
+ *        SPATIAL_CELL_LIMIT - 1] so that they fit into a packed cell key
+*/
+constexpr int32_t SPATIAL_CELL_LIMIT = 1 << (SPATIAL_CELL_BITS - 1);
+
+constexpr uint64_t SPATIAL_CELL_MASK = (uint64_t{ 1 } << SPATIAL_CELL_BITS) - 1;
+
+static uint64_t PackCell(int32_t x, int32_t y, int32_t z) {
+	return (static_cast<uint64_t>(x + SPATIAL_CELL_LIMIT) << (2 * SPATIAL_CELL_BITS))
+		| (static_cast<uint64_t>(y + SPATIAL_CELL_LIMIT) << SPATIAL_CELL_BITS)
+		| static_cast<uint64_t>(z + SPATIAL_CELL_LIMIT);
+}
+
+static int32_t UnpackCellCoordinate(uint64_t cell, int axis) {
+	const int shift = (2 - axis) * SPATIAL_CELL_BITS;
+	return static_cast<int32_t>((cell >> shift) & SPATIAL_CELL_MASK) - SPATIAL_CELL_LIMIT;
+}
+
+static float GetDistanceSquared(const SpatialPoint& a, const SpatialPoint& b) {
+	const float x = a.x - b.x;
+	const float y = a.y - b.y;
+	const float z = a.z - b.z;
+	return (x * x) + (y * y) + (z * z);
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+int32_t SpatialGrid::GetCellCoordinate(float coordinate) const {
+	const float cell = std::floor(coordinate / cellSize);
+	if (std::isnan(cell)) return 0;
+	return static_cast<int32_t>(std::clamp(cell, static_cast<float>(-SPATIAL_CELL_LIMIT),
+		static_cast<float>(SPATIAL_CELL_LIMIT - 1)));
+}
+
+uint64_t SpatialGrid::GetCell(const SpatialPoint& position) const {
+	return PackCell(GetCellCoordinate(position.x), GetCellCoordinate(position.y),
+		GetCellCoordinate(position.z));
+}
+
+void SpatialGrid::EraseFromCell(const Entry& entry) {
+	auto iterator = cells.find(entry.cell);
+	std::vector<EntityIdType>& cell = iterator->second;
+	if (entry.indexInCell != cell.size() - 1) {
+		cell[entry.indexInCell] = cell.back();
+		entries.at(cell[entry.indexInCell]).indexInCell = entry.indexInCell;
+	}
+	cell.pop_back();
+	if (cell.empty()) cells.erase(iterator);
+}
+
+template<typename TFunc>
+void SpatialGrid::ForEachInCells(const SpatialPoint& min, const SpatialPoint& max, TFunc&& function) const {
+	const int32_t minX = GetCellCoordinate(min.x);
+	const int32_t minY = GetCellCoordinate(min.y);
+	const int32_t minZ = GetCellCoordinate(min.z);
+	const int32_t maxX = GetCellCoordinate(max.x);
+	const int32_t maxY = GetCellCoordinate(max.y);
+	const int32_t maxZ = GetCellCoordinate(max.z);
+	if (minX > maxX || minY > maxY || minZ > maxZ) return;
+
+	const auto visitCell = [this, &function](const std::vector<EntityIdType>& cell) -> void {
+		for (const EntityIdType entity : cell) function(entity, entries.at(entity).position);
+	};
+
+	// boxes covering more cells than there are occupied ones filter the
+	// occupied cells instead
+	const uint64_t cellCount = static_cast<uint64_t>(maxX - minX + 1)
+		* static_cast<uint64_t>(maxY - minY + 1) * static_cast<uint64_t>(maxZ - minZ + 1);
+	if (cellCount > cells.size()) {
+		for (const auto& cellPair : cells) {
+			const int32_t x = UnpackCellCoordinate(cellPair.first, 0);
+			const int32_t y = UnpackCellCoordinate(cellPair.first, 1);
+			const int32_t z = UnpackCellCoordinate(cellPair.first, 2);
+			if (x < minX || x > maxX || y < minY || y > maxY || z < minZ || z > maxZ) continue;
+			visitCell(cellPair.second);
+		}
+		return;
+	}
+
+	for (int32_t x = minX; x <= maxX; x++) {
+		for (int32_t y = minY; y <= maxY; y++) {
+			for (int32_t z = minZ; z <= maxZ; z++) {
+				auto iterator = cells.find(PackCell(x, y, z));
+				if (iterator != cells.end()) visitCell(iterator->second);
+			}
+		}
+	}
+}
+
+SpatialGrid::SpatialGrid(float cellSize, ReadFunc read)
+	: cellSize(cellSize), read(std::move(read)) {
+	if (!(cellSize > 0.0F)) throw std::runtime_error("spatial index cell size must be positive");
+}
+
+void SpatialGrid::OnComponentChanged(const void* component) {
+	const auto [entity, position] = read(component);
+	const uint64_t cell = GetCell(position);
+
+	auto iterator = entries.find(entity);
+	if (iterator != entries.end()) {
+		iterator->second.position = position;
+		if (iterator->second.cell == cell) return;
+		EraseFromCell(iterator->second);
+	} else {
+		iterator = entries.emplace(entity, Entry{ }).first;
+		iterator->second.position = position;
+	}
+
+	std::vector<EntityIdType>& entities = cells[cell];
+	iterator->second.cell = cell;
+	iterator->second.indexInCell = entities.size();
+	entities.push_back(entity);
+}
+
+void SpatialGrid::OnComponentRemoved(EntityIdType entity) {
+	auto iterator = entries.find(entity);
+	if (iterator == entries.end()) return;
+	EraseFromCell(iterator->second);
+	entries.erase(iterator);
+}
+
+void SpatialGrid::OnComponentsCleared() {
+	cells.clear();
+	entries.clear();
+}
+
+std::vector<EntityIdType> SpatialGrid::QueryAABB(const SpatialPoint& min, const SpatialPoint& max) const {
+	std::vector<EntityIdType> result{ };
+	ForEachInCells(min, max, [&result, &min, &max](EntityIdType entity, const SpatialPoint& position) -> void {
+		if (position.x < min.x || position.x > max.x || position.y < min.y || position.y > max.y
+			|| position.z < min.z || position.z > max.z) return;
+		result.push_back(entity);
+	});
+	return result;
+}
+
+std::vector<EntityIdType> SpatialGrid::QueryRadius(const SpatialPoint& center, float radius) const {
+	std::vector<EntityIdType> result{ };
+	const float radiusSquared = radius * radius;
+	ForEachInCells({ center.x - radius, center.y - radius, center.z - radius },
+		{ center.x + radius, center.y + radius, center.z + radius },
+		[&result, &center, radiusSquared](EntityIdType entity, const SpatialPoint& position) -> void {
+			if (GetDistanceSquared(center, position) <= radiusSquared) result.push_back(entity);
+		});
+	return result;
+}
+
+std::vector<EntityIdType> SpatialGrid::QueryNearest(const SpatialPoint& center, size_t count) const {
+	std::vector<std::pair<float, EntityIdType>> candidates{ };
+	count = std::min(count, entries.size());
+	if (count == 0) return { };
+
+	// grow the search radius until it contains enough entities, everything
+	// outside of it is further away than those inside (entities at invalid
+	// positions are never found)
+	for (float radius = cellSize;; radius *= 2.0F) {
+		candidates.clear();
+		const float radiusSquared = radius * radius;
+		ForEachInCells({ center.x - radius, center.y - radius, center.z - radius },
+			{ center.x + radius, center.y + radius, center.z + radius },
+			[&candidates, &center, radiusSquared](EntityIdType entity, const SpatialPoint& position) -> void {
+				const float distanceSquared = GetDistanceSquared(center, position);
+				if (distanceSquared <= radiusSquared) candidates.emplace_back(distanceSquared, entity);
+			});
+		if (candidates.size() >= count || std::isinf(radius)) break;
+	}
+
+	count = std::min(count, candidates.size());
+
+	std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count), candidates.end());
+	std::vector<EntityIdType> result{ };
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++) result.push_back(candidates[i].second);
+	return result;
+}
+
+} // namespace Junia
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "ComponentObserver.hpp"
+#include "ECS.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A position in space (2D users leave z at 0)
+*/
+struct SpatialPoint {
+	float x = 0.0F;
+	float y = 0.0F;
+	float z = 0.0F;
+};
+
+/**
+ * @brief INTERNAL USE ONLY - A uniform grid of hashed cells holding the
+ *        positions of the components of one type
+*/
+class SpatialGrid : public ComponentObserver {
+public:
+	/**
+	 * @brief A function reading the entity and the position of a component
+	*/
+	using ReadFunc = std::function<std::pair<EntityIdType, SpatialPoint>(const void*)>;
+
+private:
+	/**
+	 * @brief The position of an entity and where it is listed in its cell
+	*/
+	struct Entry {
+		SpatialPoint position{ };
+		uint64_t cell = 0;
+		size_t indexInCell = 0;
+	};
+
+	float cellSize;
+	ReadFunc read;
+	std::unordered_map<uint64_t, std::vector<EntityIdType>> cells{ };
+	std::unordered_map<EntityIdType, Entry> entries{ };
+
+	[[nodiscard]] int32_t GetCellCoordinate(float coordinate) const;
+	[[nodiscard]] uint64_t GetCell(const SpatialPoint& position) const;
+	void EraseFromCell(const Entry& entry);
+
+	/**
+	 * @brief Call a function for every entity in the cells overlapping a box
+	 * @param min The minimum corner of the box
+	 * @param max The maximum corner of the box
+	 * @param function The function to call with each entity and its position
+	*/
+	template<typename TFunc>
+	void ForEachInCells(const SpatialPoint& min, const SpatialPoint& max, TFunc&& function) const;
+
+public:
+	SpatialGrid(float cellSize, ReadFunc read);
+
+	void OnComponentChanged(const void* component) override;
+	void OnComponentRemoved(EntityIdType entity) override;
+	void OnComponentsCleared() override;
+
+	[[nodiscard]] std::vector<EntityIdType> QueryAABB(const SpatialPoint& min, const SpatialPoint& max) const;
+	[[nodiscard]] std::vector<EntityIdType> QueryRadius(const SpatialPoint& center, float radius) const;
+	[[nodiscard]] std::vector<EntityIdType> QueryNearest(const SpatialPoint& center, size_t count) const;
+};
+
+/**
+ * @brief A spatial index over the components of type T of the active world
+ *        (at creation), for range and nearest neighbour queries. Added and
+ *        removed components are tracked by the world, positions of
+ *        components handed out by GetComponent() or a ComponentRef are read
+ *        again before the next query. Only query while that world is active
+ *        (forks do not inherit indices).
+ * @tparam T The (position-like) component type to index
+*/
+template<TypenameDerivedFrom<Component> T>
+class SpatialIndex {
+private:
+	std::shared_ptr<SpatialGrid> grid;
+
+	static std::vector<Entity> ToEntities(const std::vector<EntityIdType>& entityIds);
+
+public:
+	/**
+	 * @brief A function getting the position of a component
+	*/
+	using PositionFunc = std::function<SpatialPoint(const T&)>;
+
+	/**
+	 * @brief Create an index and register it with the active world
+	 * @param cellSize The edge length of the grid cells (around the typical
+	 *                 query radius works best)
+	 * @param position A function getting the position of a component
+	*/
+	SpatialIndex(float cellSize, PositionFunc position);
+
+	/**
+	 * @brief Get the entities inside of an axis aligned box
+	 * @param min The minimum corner of the box
+	 * @param max The maximum corner of the box
+	 * @return The entities inside of the box (borders included)
+	*/
+	[[nodiscard]] std::vector<Entity> QueryAABB(const SpatialPoint& min, const SpatialPoint& max);
+
+	/**
+	 * @brief Get the entities inside of a sphere
+	 * @param center The center of the sphere
+	 * @param radius The radius of the sphere
+	 * @return The entities at most radius away from center
+	*/
+	[[nodiscard]] std::vector<Entity> QueryRadius(const SpatialPoint& center, float radius);
+
+	/**
+	 * @brief Get the entities closest to a position
+	 * @param center The position
+	 * @param count The maximum amount of entities to get
+	 * @return Up to count entities ordered by distance to center
+	*/
+	[[nodiscard]] std::vector<Entity> QueryNearest(const SpatialPoint& center, size_t count);
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+template<TypenameDerivedFrom<Component> T>
+inline std::vector<Entity> SpatialIndex<T>::ToEntities(const std::vector<EntityIdType>& entityIds) {
+	std::vector<Entity> entities{ };
+	entities.reserve(entityIds.size());
+	for (const EntityIdType entityId : entityIds) entities.push_back(Entity::Get(entityId));
+	return entities;
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline SpatialIndex<T>::SpatialIndex(float cellSize, PositionFunc position)
+	: grid(std::make_shared<SpatialGrid>(cellSize,
+		[position = std::move(position)](const void* ptr) -> std::pair<EntityIdType, SpatialPoint> {
+			const T& component = *static_cast<const T*>(ptr);
+			return { component.GetEntity().GetId(), position(component) };
+		})) {
+	RegisterComponentObserver(typeid(T), grid);
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline std::vector<Entity> SpatialIndex<T>::QueryAABB(const SpatialPoint& min, const SpatialPoint& max) {
+	FlushComponentChanges(typeid(T));
+	return ToEntities(grid->QueryAABB(min, max));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline std::vector<Entity> SpatialIndex<T>::QueryRadius(const SpatialPoint& center, float radius) {
+	FlushComponentChanges(typeid(T));
+	return ToEntities(grid->QueryRadius(center, radius));
+}
+
+template<TypenameDerivedFrom<Component> T>
+inline std::vector<Entity> SpatialIndex<T>::QueryNearest(const SpatialPoint& center, size_t count) {
+	FlushComponentChanges(typeid(T));
+	return ToEntities(grid->QueryNearest(center, count));
+}
+
+} // namespace Junia
@@ -0,0 +1,57 @@
+#include "Stats.hpp"
+#include "World.hpp"
+
+#include <iomanip>
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ------------------------------- Free functions ------------------------------
+// -----------------------------------------------------------------------------
+
+void WriteStatsReport(std::ostream& stream, const WorldStats& stats) {
+	stream << "entities: " << stats.entities.liveCount << " live, "
+		<< stats.entities.freeCount << " free, "
+		<< stats.entities.bytesAllocated << " bytes, "
+		<< stats.entities.nextCalls << " created, "
+		<< stats.entities.freeCalls << " destroyed\n";
+
+	for (const ComponentStoreStats& store : stats.stores) {
+		stream << store.typeName << ": "
+			<< store.liveCount << '/' << store.capacity << " live, "
+			<< store.holeCount << " holes, "
+			<< store.pageCount << " pages (" << store.sharedPageCount << " shared, "
+			<< store.pageAllocations << " allocated), "
+			<< store.bytesAllocated << " bytes, "
+			<< store.addCalls << " adds, "
+			<< store.removeCalls << " removes, "
+			<< store.getCalls << " gets\n";
+	}
+
+	constexpr double NANOSECONDS_PER_MILLISECOND = 1e6;
+	for (const SystemTimingStats& system : stats.systems) {
+		const double average = system.calls == 0 ? 0.0
+			: static_cast<double>(system.total.count()) / static_cast<double>(system.calls);
+		stream << system.name << ": " << system.calls << " runs, " << std::fixed << std::setprecision(3)
+			<< static_cast<double>(system.total.count()) / NANOSECONDS_PER_MILLISECOND << " ms total, "
+			<< average / NANOSECONDS_PER_MILLISECOND << " ms average, "
+			<< static_cast<double>(system.max.count()) / NANOSECONDS_PER_MILLISECOND << " ms max\n"
+			<< std::defaultfloat;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+#ifdef JUNIA_ECS_STATS
+ScopedSystemTimer::ScopedSystemTimer(const char* systemName)
+	: name(systemName), start(std::chrono::steady_clock::now()) { }
+
+ScopedSystemTimer::~ScopedSystemTimer() {
+	World::GetActiveWorld().RecordSystemTime(name, std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start));
+}
+#endif
+
+} // namespace Junia
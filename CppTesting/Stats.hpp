@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Define JUNIA_ECS_STATS (for all translation units) to enable call counters
+// and system timings. Without it only the statistics that can be computed from
+// the data structures themselves are available and nothing is counted.
+
+namespace Junia {
+
+// -----------------------------------------------------------------------------
+// ------------------------------------ Stats ----------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Statistics of an ID pool
+*/
+struct IdPoolStats {
+	size_t liveCount = 0;
+	size_t freeCount = 0;
+	size_t freeCapacity = 0;
+	size_t bytesAllocated = 0;
+	uint64_t nextCalls = 0;
+	uint64_t freeCalls = 0;
+};
+
+/**
+ * @brief Statistics of a component store (call counters are only counted if
+ *        JUNIA_ECS_STATS is defined)
+*/
+struct ComponentStoreStats {
+	std::string typeName{ };
+	size_t liveCount = 0;
+	size_t capacity = 0;
+	size_t holeCount = 0;
+	size_t pageCount = 0;
+	size_t sharedPageCount = 0;
+	size_t bytesAllocated = 0;
+	uint64_t pageAllocations = 0;
+	uint64_t addCalls = 0;
+	uint64_t removeCalls = 0;
+	uint64_t getCalls = 0;
+};
+
+/**
+ * @brief Accumulated timings of a system (only recorded if JUNIA_ECS_STATS is
+ *        defined)
+*/
+struct SystemTimingStats {
+	std::string name{ };
+	uint64_t calls = 0;
+	std::chrono::nanoseconds total{ };
+	std::chrono::nanoseconds max{ };
+};
+
+/**
+ * @brief Statistics of a world
+*/
+struct WorldStats {
+	IdPoolStats entities{ };
+	std::vector<ComponentStoreStats> stores{ };
+	std::vector<SystemTimingStats> systems{ };
+};
+
+/**
+ * @brief Write statistics as a human readable table
+ * @param stream The stream to write to
+ * @param stats The statistics (e.g. from World::GetStats())
+*/
+void WriteStatsReport(std::ostream& stream, const WorldStats& stats);
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Classes ----------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Measures the time until it goes out of scope and records it for a
+ *        system of the active world (does nothing unless JUNIA_ECS_STATS is
+ *        defined). Timers of systems running on several threads at once may
+ *        record concurrently.
+*/
+class ScopedSystemTimer {
+#ifdef JUNIA_ECS_STATS
+private:
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	/**
+	 * @brief Start timing a system
+	 * @param systemName The name of the system (must outlive the timer)
+	*/
+	explicit ScopedSystemTimer(const char* systemName);
+	~ScopedSystemTimer();
+#else
+public:
+	explicit ScopedSystemTimer(const char* /*systemName*/) { }
+	~ScopedSystemTimer() = default;
+#endif
+
+	ScopedSystemTimer(const ScopedSystemTimer&) = delete;
+	ScopedSystemTimer(ScopedSystemTimer&&) = delete;
+	ScopedSystemTimer& operator=(const ScopedSystemTimer&) = delete;
+	ScopedSystemTimer& operator=(ScopedSystemTimer&&) = delete;
+};
+
+} // namespace Junia
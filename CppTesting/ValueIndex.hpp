@@ -0,0 +1,258 @@
+#pragma once
+
+#include "ComponentObserver.hpp"
+#include "ECS.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief The lookup structure of a value index
+*/
+enum class ValueIndexKind {
+	Hash,
+	Sorted
+};
+
+// -----------------------------------------------------------------------------
+// -------------------------------- Declarations -------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief INTERNAL USE ONLY - The entities of one component type grouped by a
+ *        key read from their components
+ * @tparam TKey The type of the key
+ * @tparam TMap The map from keys to entities (std::unordered_map or
+ *              std::map)
+*/
+template<typename TKey, typename TMap>
+class ValueIndexObserver : public ComponentObserver {
+public:
+	/**
+	 * @brief A function reading the entity and the key of a component
+	*/
+	using ReadFunc = std::function<std::pair<EntityIdType, TKey>(const void*)>;
+
+private:
+	/**
+	 * @brief Where an entity is listed (the group is held by pointer, which
+	 *        unlike an iterator stays valid when std::unordered_map rehashes)
+	*/
+	struct Entry {
+		typename TMap::value_type* group = nullptr;
+		size_t indexInGroup = 0;
+	};
+
+	ReadFunc read;
+	TMap groups{ };
+	std::unordered_map<EntityIdType, Entry> entries{ };
+
+	void EraseFromGroup(const Entry& entry);
+	[[nodiscard]] bool IsSameKey(const TKey& a, const TKey& b) const;
+
+public:
+	explicit ValueIndexObserver(ReadFunc read);
+
+	void OnComponentChanged(const void* component) override;
+	void OnComponentRemoved(EntityIdType entity) override;
+	void OnComponentsCleared() override;
+
+	[[nodiscard]] const TMap& GetGroups() const;
+};
+
+/**
+ * @brief An index of the components of type T of the active world (at
+ *        creation) by a key read from each component, e.g. a network id or a
+ *        team. Added and removed components are tracked by the world, keys of
+ *        components handed out by GetComponent() or a ComponentRef are read
+ *        again before the next lookup. Only look up while that world is
+ *        active (forks do not inherit indices).
+ * @tparam T The component type to index
+ * @tparam TKey The type of the key (hashable for ValueIndexKind::Hash,
+ *              ordered by operator< for ValueIndexKind::Sorted)
+ * @tparam Kind Hash for O(1) lookups, Sorted to also look up key ranges in
+ *              O(log n)
+*/
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind = ValueIndexKind::Hash>
+class ValueIndex {
+private:
+	using MapType = std::conditional_t<Kind == ValueIndexKind::Hash,
+		std::unordered_map<TKey, std::vector<EntityIdType>>, std::map<TKey, std::vector<EntityIdType>>>;
+
+	std::shared_ptr<ValueIndexObserver<TKey, MapType>> observer;
+
+	[[nodiscard]] const MapType& GetGroups();
+
+public:
+	/**
+	 * @brief A function getting the key of a component
+	*/
+	using KeyFunc = std::function<TKey(const T&)>;
+
+	/**
+	 * @brief Create an index and register it with the active world
+	 * @param key A function getting the key of a component
+	*/
+	explicit ValueIndex(KeyFunc key);
+
+	/**
+	 * @brief Get all entities whose component has a key
+	 * @param key The key to look up
+	 * @return The entities (in no particular order)
+	*/
+	[[nodiscard]] std::vector<Entity> Find(const TKey& key);
+
+	/**
+	 * @brief Get an entity whose component has a key (for unique keys)
+	 * @param key The key to look up
+	 * @return One of the entities, or nothing if there is none
+	*/
+	[[nodiscard]] std::optional<Entity> FindFirst(const TKey& key);
+
+	/**
+	 * @brief Get the amount of entities whose component has a key
+	 * @param key The key to look up
+	 * @return The amount of entities
+	*/
+	[[nodiscard]] size_t Count(const TKey& key);
+
+	/**
+	 * @brief Get all entities whose component has a key in a range (only for
+	 *        ValueIndexKind::Sorted)
+	 * @param min The smallest key to include
+	 * @param max The largest key to include
+	 * @return The entities ordered by key
+	*/
+	[[nodiscard]] std::vector<Entity> FindRange(const TKey& min, const TKey& max)
+		requires (Kind == ValueIndexKind::Sorted);
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// ---------------------- ValueIndexObserver<TKey, TMap> -----------------------
+
+template<typename TKey, typename TMap>
+inline ValueIndexObserver<TKey, TMap>::ValueIndexObserver(ReadFunc read)
+	: read(std::move(read)) { }
+
+template<typename TKey, typename TMap>
+inline void ValueIndexObserver<TKey, TMap>::EraseFromGroup(const Entry& entry) {
+	std::vector<EntityIdType>& group = entry.group->second;
+	if (entry.indexInGroup != group.size() - 1) {
+		group[entry.indexInGroup] = group.back();
+		entries.at(group[entry.indexInGroup]).indexInGroup = entry.indexInGroup;
+	}
+	group.pop_back();
+	if (group.empty()) groups.erase(groups.find(entry.group->first));
+}
+
+template<typename TKey, typename TMap>
+inline bool ValueIndexObserver<TKey, TMap>::IsSameKey(const TKey& a, const TKey& b) const {
+	// the equivalence of the map, so sorted keys only need operator<
+	if constexpr (requires { groups.key_eq(); }) return groups.key_eq()(a, b);
+	else return !groups.key_comp()(a, b) && !groups.key_comp()(b, a);
+}
+
+template<typename TKey, typename TMap>
+inline void ValueIndexObserver<TKey, TMap>::OnComponentChanged(const void* component) {
+	auto [entity, key] = read(component);
+
+	auto iterator = entries.find(entity);
+	if (iterator != entries.end()) {
+		if (IsSameKey(iterator->second.group->first, key)) return;
+		EraseFromGroup(iterator->second);
+	} else {
+		iterator = entries.emplace(entity, Entry{ }).first;
+	}
+
+	auto& group = *groups.try_emplace(std::move(key)).first;
+	iterator->second.group = &group;
+	iterator->second.indexInGroup = group.second.size();
+	group.second.push_back(entity);
+}
+
+template<typename TKey, typename TMap>
+inline void ValueIndexObserver<TKey, TMap>::OnComponentRemoved(EntityIdType entity) {
+	auto iterator = entries.find(entity);
+	if (iterator == entries.end()) return;
+	EraseFromGroup(iterator->second);
+	entries.erase(iterator);
+}
+
+template<typename TKey, typename TMap>
+inline void ValueIndexObserver<TKey, TMap>::OnComponentsCleared() {
+	entries.clear();
+	groups.clear();
+}
+
+template<typename TKey, typename TMap>
+inline const TMap& ValueIndexObserver<TKey, TMap>::GetGroups() const {
+	return groups;
+}
+
+// ---------------------------- ValueIndex<T, TKey> ----------------------------
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline ValueIndex<T, TKey, Kind>::ValueIndex(KeyFunc key)
+	: observer(std::make_shared<ValueIndexObserver<TKey, MapType>>(
+		[key = std::move(key)](const void* ptr) -> std::pair<EntityIdType, TKey> {
+			const T& component = *static_cast<const T*>(ptr);
+			return { component.GetEntity().GetId(), key(component) };
+		})) {
+	RegisterComponentObserver(typeid(T), observer);
+}
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline const typename ValueIndex<T, TKey, Kind>::MapType& ValueIndex<T, TKey, Kind>::GetGroups() {
+	FlushComponentChanges(typeid(T));
+	return observer->GetGroups();
+}
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline std::vector<Entity> ValueIndex<T, TKey, Kind>::Find(const TKey& key) {
+	const MapType& groups = GetGroups();
+	std::vector<Entity> entities{ };
+	auto iterator = groups.find(key);
+	if (iterator == groups.end()) return entities;
+	entities.reserve(iterator->second.size());
+	for (const EntityIdType entity : iterator->second) entities.push_back(Entity::Get(entity));
+	return entities;
+}
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline std::optional<Entity> ValueIndex<T, TKey, Kind>::FindFirst(const TKey& key) {
+	const MapType& groups = GetGroups();
+	auto iterator = groups.find(key);
+	if (iterator == groups.end()) return std::nullopt;
+	return Entity::Get(iterator->second.front());
+}
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline size_t ValueIndex<T, TKey, Kind>::Count(const TKey& key) {
+	const MapType& groups = GetGroups();
+	auto iterator = groups.find(key);
+	return iterator == groups.end() ? 0 : iterator->second.size();
+}
+
+template<TypenameDerivedFrom<Component> T, typename TKey, ValueIndexKind Kind>
+inline std::vector<Entity> ValueIndex<T, TKey, Kind>::FindRange(const TKey& min, const TKey& max)
+	requires (Kind == ValueIndexKind::Sorted) {
+	const MapType& groups = GetGroups();
+	std::vector<Entity> entities{ };
+	for (auto iterator = groups.lower_bound(min); iterator != groups.end() && !(max < iterator->first); iterator++) {
+		for (const EntityIdType entity : iterator->second) entities.push_back(Entity::Get(entity));
+	}
+	return entities;
+}
+
+} // namespace Junia
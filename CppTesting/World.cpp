@@ -0,0 +1,310 @@
+#include "World.hpp"
+#include "AsyncSystem.hpp"
+#include "ComponentObserver.hpp"
+#include "ComponentStore.hpp"
+#include "Events.hpp"
+#include "Query.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace Junia {
+
+/**
+ * @brief Call a function for every registered object that is still alive
+ *        (and drop the destroyed ones)
+ * @param registered The registered query caches, observers or event channels
+ * @param function The function to call with each object
+*/
+template<typename T, typename TFunc>
+static void ForEachAlive(std::vector<std::weak_ptr<T>>& registered, TFunc&& function) {
+	for (size_t i = 0; i < registered.size();) {
+		const std::shared_ptr<T> object = registered[i].lock();
+		if (object == nullptr) {
+			registered[i] = std::move(registered.back());
+			registered.pop_back();
+			continue;
+		}
+		function(*object);
+		i++;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Static functions -----------------------------
+// -----------------------------------------------------------------------------
+
+std::shared_ptr<World>& World::GetActivePointer() {
+	static std::shared_ptr<World> active = std::make_shared<World>();
+	return active;
+}
+
+std::shared_ptr<World> World::GetActive() {
+	return GetActivePointer();
+}
+
+std::shared_ptr<World> World::SetActive(std::shared_ptr<World> world) {
+	if (world == nullptr) throw std::runtime_error("cannot activate a null world");
+	std::swap(GetActivePointer(), world);
+	return world;
+}
+
+World& World::GetActiveWorld() {
+	return *GetActivePointer();
+}
+
+ResourceIdType World::AllocateResourceId() {
+	static std::atomic<ResourceIdType> next{ 0 };
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Member functions -----------------------------
+// -----------------------------------------------------------------------------
+
+std::shared_ptr<World> World::Fork() const {
+	auto world = std::make_shared<World>();
+	world->entityPool = entityPool;
+	world->hierarchy = hierarchy;
+	world->disabledEntities = disabledEntities;
+	world->entityGenerations = entityGenerations;
+	world->resources = resources;
+	for (Resource& resource : world->resources) {
+		if (resource.value != nullptr && resource.copy) resource.value = resource.copy(resource.value.get());
+	}
+	world->componentStores.reserve(componentStores.size());
+	for (const auto& componentStorePair : componentStores) {
+		world->componentStores[componentStorePair.first] =
+			std::make_shared<ComponentStore>(*componentStorePair.second);
+	}
+	return world;
+}
+
+void World::EndFrame() {
+	for (auto& componentStorePair : componentStores) componentStorePair.second->SwapBuffers();
+	ForEachAlive(eventChannels, [](EventChannelBase& channel) -> void {
+		channel.OnEndFrame();
+	});
+	if (asyncScheduler != nullptr) asyncScheduler->Update();
+}
+
+World::ComponentStoreMapType& World::GetComponentStores() {
+	return componentStores;
+}
+
+IdPool<EntityIdType>& World::GetEntityPool() {
+	return entityPool;
+}
+
+AsyncScheduler& World::GetAsyncScheduler() {
+	if (asyncScheduler == nullptr) asyncScheduler = std::make_shared<AsyncScheduler>();
+	return *asyncScheduler;
+}
+
+Hierarchy& World::GetHierarchy() {
+	return hierarchy;
+}
+
+void World::RegisterQuery(const std::shared_ptr<QueryCache>& cache) {
+	for (const std::type_index type : cache->GetTypes()) queriesByType[type].push_back(cache);
+	cache->Rebuild(*this);
+}
+
+void World::OnComponentAdded(std::type_index type, EntityIdType entity) {
+	auto iterator = queriesByType.find(type);
+	if (iterator == queriesByType.end()) return;
+	ForEachAlive(iterator->second, [this, entity](QueryCache& cache) -> void {
+		cache.OnComponentAdded(*this, entity);
+	});
+}
+
+void World::OnComponentsAdded(std::type_index type, const std::vector<EntityIdType>& entities) {
+	auto iterator = queriesByType.find(type);
+	if (iterator == queriesByType.end()) return;
+	ForEachAlive(iterator->second, [this, &entities](QueryCache& cache) -> void {
+		for (const EntityIdType entity : entities) cache.OnComponentAdded(*this, entity);
+	});
+}
+
+void World::RegisterObserver(std::type_index type, const std::shared_ptr<ComponentObserver>& observer) {
+	// looked up first, an unregistered type throws before anything changes
+	ComponentStore& store = *componentStores.at(type);
+	// everyone (again) receives all components on the next flush
+	FlushChanges(type);
+	observersByType[type].push_back(observer);
+	store.SetChangeTracking(true);
+}
+
+void World::RegisterEventChannel(const std::shared_ptr<EventChannelBase>& channel) {
+	eventChannels.push_back(channel);
+}
+
+void World::FlushChanges(std::type_index type) {
+	auto iterator = observersByType.find(type);
+	if (iterator == observersByType.end()) return;
+	auto storeIterator = componentStores.find(type);
+	if (storeIterator == componentStores.end()) return;
+
+	const std::vector<const void*> changed = storeIterator->second->TakeChangedComponents();
+	ForEachAlive(iterator->second, [&changed](ComponentObserver& observer) -> void {
+		for (const void* component : changed) observer.OnComponentChanged(component);
+	});
+	if (!iterator->second.empty()) return;
+	storeIterator->second->SetChangeTracking(false);
+	observersByType.erase(iterator);
+}
+
+void World::OnComponentRemoved(std::type_index type, EntityIdType entity) {
+	auto iterator = queriesByType.find(type);
+	if (iterator != queriesByType.end()) {
+		ForEachAlive(iterator->second, [entity](QueryCache& cache) -> void {
+			cache.OnComponentRemoved(entity);
+		});
+	}
+
+	auto observerIterator = observersByType.find(type);
+	if (observerIterator == observersByType.end()) return;
+	ForEachAlive(observerIterator->second, [entity](ComponentObserver& observer) -> void {
+		observer.OnComponentRemoved(entity);
+	});
+}
+
+void World::OnComponentEnabledChanged(std::type_index type, EntityIdType entity) {
+	auto iterator = queriesByType.find(type);
+	if (iterator == queriesByType.end()) return;
+	ForEachAlive(iterator->second, [this, entity](QueryCache& cache) -> void {
+		cache.OnEnabledChanged(*this, entity);
+	});
+}
+
+void World::OnEntityDestroyed(EntityIdType entity) {
+	OnEntityIdReleased(entity);
+	disabledEntities.Set(entity, false);
+	for (auto& queryPair : queriesByType) {
+		ForEachAlive(queryPair.second, [entity](QueryCache& cache) -> void {
+			cache.OnComponentRemoved(entity);
+		});
+	}
+	for (auto& observerPair : observersByType) {
+		ForEachAlive(observerPair.second, [entity](ComponentObserver& observer) -> void {
+			observer.OnComponentRemoved(entity);
+		});
+	}
+}
+
+void World::OnEntityIdReleased(EntityIdType entity) {
+	if (entityGenerations.size() <= entity) entityGenerations.resize(entity + 1, 0);
+	entityGenerations[entity]++;
+}
+
+uint32_t World::GetEntityGeneration(EntityIdType entity) const {
+	return entity < entityGenerations.size() ? entityGenerations[entity] : 0;
+}
+
+void World::OnStoreReplaced(std::type_index type) {
+	auto iterator = queriesByType.find(type);
+	if (iterator != queriesByType.end())
+		ForEachAlive(iterator->second, [this](QueryCache& cache) -> void { cache.Rebuild(*this); });
+
+	auto observerIterator = observersByType.find(type);
+	if (observerIterator == observersByType.end()) return;
+	ForEachAlive(observerIterator->second, [](ComponentObserver& observer) -> void {
+		observer.OnComponentsCleared();
+	});
+	auto storeIterator = componentStores.find(type);
+	if (storeIterator != componentStores.end()) storeIterator->second->SetChangeTracking(true);
+}
+
+void World::OnStoresReplaced() {
+	// loaded state is visible to reads right away
+	for (auto& componentStorePair : componentStores) componentStorePair.second->SwapBuffers();
+
+	// queries involving several types are listed once per type
+	std::unordered_set<QueryCache*> rebuilt{ };
+	for (auto& queryPair : queriesByType) {
+		ForEachAlive(queryPair.second, [this, &rebuilt](QueryCache& cache) -> void {
+			if (rebuilt.insert(&cache).second) cache.Rebuild(*this);
+		});
+	}
+
+	for (auto& observerPair : observersByType) {
+		ForEachAlive(observerPair.second, [](ComponentObserver& observer) -> void {
+			observer.OnComponentsCleared();
+		});
+		auto storeIterator = componentStores.find(observerPair.first);
+		if (storeIterator != componentStores.end()) storeIterator->second->SetChangeTracking(true);
+	}
+}
+
+void World::SetResource(ResourceIdType id, std::shared_ptr<void> value, ResourceCopyFunc copy) {
+	if (resources.size() <= id) resources.resize(id + 1);
+	resources[id].value = std::move(value);
+	resources[id].copy = std::move(copy);
+}
+
+void World::RemoveResource(ResourceIdType id) {
+	if (id < resources.size()) resources[id] = Resource{ };
+}
+
+void World::SetEntityEnabled(EntityIdType entity, bool enabled) {
+	if (IsEntityEnabled(entity) == enabled) return;
+	disabledEntities.Set(entity, !enabled);
+
+	// only queries over types the entity has can contain it, queries involving
+	// several types are listed once per type
+	std::unordered_set<QueryCache*> updated{ };
+	for (auto& queryPair : queriesByType) {
+		auto storeIterator = componentStores.find(queryPair.first);
+		if (storeIterator == componentStores.end() || !storeIterator->second->HasComponent(entity)) continue;
+		ForEachAlive(queryPair.second, [this, entity, &updated](QueryCache& cache) -> void {
+			if (updated.insert(&cache).second) cache.OnEnabledChanged(*this, entity);
+		});
+	}
+}
+
+const Bitset& World::GetDisabledEntities() const {
+	return disabledEntities;
+}
+
+void World::RestoreDisabledEntities(Bitset disabled) {
+	disabledEntities = std::move(disabled);
+}
+
+WorldStats World::GetStats() const {
+	WorldStats stats{ };
+	stats.entities = entityPool.GetStats();
+	stats.stores.reserve(componentStores.size());
+	for (const auto& componentStorePair : componentStores) {
+		stats.stores.push_back(componentStorePair.second->GetStats());
+		stats.stores.back().typeName = componentStorePair.first.name();
+	}
+	std::sort(stats.stores.begin(), stats.stores.end(),
+		[](const ComponentStoreStats& a, const ComponentStoreStats& b) -> bool { return a.typeName < b.typeName; });
+#ifdef JUNIA_ECS_STATS
+	const std::lock_guard<std::mutex> lock(systemTimingsMutex);
+	stats.systems.reserve(systemTimings.size());
+	for (const auto& systemTimingPair : systemTimings) stats.systems.push_back(systemTimingPair.second);
+	std::sort(stats.systems.begin(), stats.systems.end(),
+		[](const SystemTimingStats& a, const SystemTimingStats& b) -> bool { return a.name < b.name; });
+#endif
+	return stats;
+}
+
+#ifdef JUNIA_ECS_STATS
+void World::RecordSystemTime(const char* name, std::chrono::nanoseconds duration) {
+	const std::lock_guard<std::mutex> lock(systemTimingsMutex);
+	auto iterator = systemTimings.find(name);
+	if (iterator == systemTimings.end()) {
+		iterator = systemTimings.emplace(name, SystemTimingStats{ }).first;
+		iterator->second.name = name;
+	}
+	SystemTimingStats& timing = iterator->second;
+	timing.calls++;
+	timing.total += duration;
+	timing.max = std::max(timing.max, duration);
+}
+#endif
+
+} // namespace Junia
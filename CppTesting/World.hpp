@@ -0,0 +1,372 @@
+#pragma once
+
+#include "Bitset.hpp"
+#include "ECS.hpp"
+#include "Hierarchy.hpp"
+#include "IdPool.hpp"
+#include "Stats.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace Junia {
+
+/**
+ * @brief Type for ResourceIDs (dense, one per resource type, see
+ *        Junia::GetResourceId())
+*/
+using ResourceIdType = size_t;
+
+// Forward declarations for use in World class
+class AsyncScheduler;
+class ComponentObserver;
+class ComponentStore;
+class EventChannelBase;
+class QueryCache;
+
+/**
+ * @brief The state of the ECS (entities and component stores). All ECS
+ *        functions operate on the active world.
+*/
+class World {
+public:
+	using ComponentStoreMapType = std::unordered_map<std::type_index, std::shared_ptr<ComponentStore>>;
+
+	/**
+	 * @brief A function copying a resource for a forked world (nullptr for
+	 *        resources that are shared between forks)
+	*/
+	using ResourceCopyFunc = std::function<std::shared_ptr<void>(const void*)>;
+
+private:
+	/**
+	 * @brief The component stores of this world by component type
+	*/
+	ComponentStoreMapType componentStores{ };
+
+	/**
+	 * @brief The pool entity ids of this world are taken from
+	*/
+	IdPool<EntityIdType> entityPool{ };
+
+	/**
+	 * @brief The parent/child relationships between the entities of this
+	 *        world
+	*/
+	Hierarchy hierarchy{ };
+
+	/**
+	 * @brief The disabled entities of this world by entity id
+	*/
+	Bitset disabledEntities{ };
+
+	/**
+	 * @brief How often each entity id has been given up (by destroying its
+	 *        entity or loading a snapshot without it) by entity id
+	*/
+	std::vector<uint32_t> entityGenerations{ };
+
+	/**
+	 * @brief A singleton resource of this world
+	*/
+	struct Resource {
+		std::shared_ptr<void> value{ };
+		ResourceCopyFunc copy{ };
+	};
+
+	/**
+	 * @brief The resources of this world by resource id
+	*/
+	std::vector<Resource> resources{ };
+
+	/**
+	 * @brief The registered queries by the component types they involve
+	*/
+	std::unordered_map<std::type_index, std::vector<std::weak_ptr<QueryCache>>> queriesByType{ };
+
+	/**
+	 * @brief The registered component observers by observed component type
+	*/
+	std::unordered_map<std::type_index, std::vector<std::weak_ptr<ComponentObserver>>> observersByType{ };
+
+	/**
+	 * @brief The registered event channels
+	*/
+	std::vector<std::weak_ptr<EventChannelBase>> eventChannels{ };
+
+#ifdef JUNIA_ECS_STATS
+	/**
+	 * @brief The timings recorded through ScopedSystemTimer by system name
+	 *        (guarded by systemTimingsMutex, systems may run on any thread)
+	*/
+	std::unordered_map<std::string, SystemTimingStats> systemTimings{ };
+	mutable std::mutex systemTimingsMutex{ };
+#endif
+
+	/**
+	 * @brief The async systems of this world (created on first use, declared
+	 *        last so the systems are destroyed before the rest of the world)
+	*/
+	std::shared_ptr<AsyncScheduler> asyncScheduler{ };
+
+	static std::shared_ptr<World>& GetActivePointer();
+
+public:
+	/**
+	 * @brief Get the active world
+	 * @return A pointer to the world all ECS functions currently operate on
+	*/
+	static std::shared_ptr<World> GetActive();
+
+	/**
+	 * @brief Make a world the active world
+	 * @param world The world all ECS functions are going to operate on
+	 * @return The previously active world
+	*/
+	static std::shared_ptr<World> SetActive(std::shared_ptr<World> world);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the active world without touching its
+	 *        reference count
+	 * @return A reference to the active world
+	*/
+	static World& GetActiveWorld();
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get an unused resource id
+	 * @return The next resource id
+	*/
+	static ResourceIdType AllocateResourceId();
+
+	/**
+	 * @brief Create a copy of this world. Component pages and entity tables
+	 *        are shared until either world writes to them, so forking only
+	 *        costs a pointer copy per page. Component types registered after
+	 *        forking are only known to the world they were registered in.
+	 *        Copyable resources are copied, the others are shared. Async
+	 *        systems are not copied.
+	 * @return The new world (not activated)
+	*/
+	[[nodiscard]] std::shared_ptr<World> Fork() const;
+
+	/**
+	 * @brief Mark the boundary between two frames: the components written to
+	 *        double buffered stores during the frame become visible to reads,
+	 *        the events sent two frames ago are dropped and the async systems
+	 *        whose awaited frame, timer or job has come are resumed
+	*/
+	void EndFrame();
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the component stores of this world
+	 * @return A reference to the component stores by component type
+	*/
+	ComponentStoreMapType& GetComponentStores();
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the entity pool of this world
+	 * @return A reference to the entity pool
+	*/
+	IdPool<EntityIdType>& GetEntityPool();
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the scheduler of the async systems of
+	 *        this world
+	 * @return A reference to the scheduler
+	*/
+	AsyncScheduler& GetAsyncScheduler();
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the entity hierarchy of this world
+	 * @return A reference to the hierarchy
+	*/
+	Hierarchy& GetHierarchy();
+
+	/**
+	 * @brief Enable or disable an entity (disabled entities are skipped when
+	 *        iterating queries, their components stay in place)
+	 * @param entity The id of the entity
+	 * @param enabled Whether the entity is enabled
+	*/
+	void SetEntityEnabled(EntityIdType entity, bool enabled);
+
+	/**
+	 * @brief Check whether an entity is enabled
+	 * @param entity The id of the entity
+	 * @return true unless the entity has been disabled
+	*/
+	[[nodiscard]] bool IsEntityEnabled(EntityIdType entity) const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the disabled entities (for snapshots)
+	 * @return A const reference to the bits of the disabled entity ids
+	*/
+	[[nodiscard]] const Bitset& GetDisabledEntities() const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Replace the disabled entities (the queries
+	 *        have to be rebuilt afterwards, see World::OnStoresReplaced())
+	 * @param disabled The bits of the disabled entity ids
+	*/
+	void RestoreDisabledEntities(Bitset disabled);
+
+	/**
+	 * @brief Collect the statistics of the entity pool, all component stores
+	 *        (ordered by type name) and all timed systems of this world. Call
+	 *        counters and system timings are only recorded if
+	 *        JUNIA_ECS_STATS is defined; the stores of forks start counting
+	 *        from zero.
+	 * @return The current statistics
+	*/
+	[[nodiscard]] WorldStats GetStats() const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Set a resource (see Junia::SetResource())
+	 * @param id The id of the resource
+	 * @param value The resource
+	 * @param copy A function copying the resource for forks (or nullptr)
+	*/
+	void SetResource(ResourceIdType id, std::shared_ptr<void> value, ResourceCopyFunc copy);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Remove a resource
+	 * @param id The id of the resource
+	*/
+	void RemoveResource(ResourceIdType id);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get a resource (see Junia::GetResource())
+	 * @param id The id of the resource
+	 * @return A pointer to the resource, nullptr if it has not been set
+	*/
+	[[nodiscard]] void* FindResource(ResourceIdType id) const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Keep a query cache up to date from now on
+	 *        (until it is destroyed)
+	 * @param cache The query cache to register
+	*/
+	void RegisterQuery(const std::shared_ptr<QueryCache>& cache);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Report changes of a component type to an
+	 *        observer from now on (until it is destroyed)
+	 * @param type The component type
+	 * @param observer The observer to register
+	*/
+	void RegisterObserver(std::type_index type, const std::shared_ptr<ComponentObserver>& observer);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update an event channel at the end of every
+	 *        frame from now on (until it is destroyed)
+	 * @param channel The event channel to register
+	*/
+	void RegisterEventChannel(const std::shared_ptr<EventChannelBase>& channel);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Report the components of a type that have
+	 *        been added or handed out for writing since the last flush to its
+	 *        observers
+	 * @param type The component type
+	*/
+	void FlushChanges(std::type_index type);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update the queries after a component has
+	 *        been added
+	 * @param type The type of the component
+	 * @param entity The entity the component has been added to
+	*/
+	void OnComponentAdded(std::type_index type, EntityIdType entity);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update the queries after a component has
+	 *        been added to a batch of entities
+	 * @param type The type of the components
+	 * @param entities The entities the components have been added to
+	*/
+	void OnComponentsAdded(std::type_index type, const std::vector<EntityIdType>& entities);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update the queries and observers after a
+	 *        component has been removed
+	 * @param type The type of the component
+	 * @param entity The entity the component has been removed from
+	*/
+	void OnComponentRemoved(std::type_index type, EntityIdType entity);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update the queries after a component has
+	 *        been enabled or disabled
+	 * @param type The type of the component
+	 * @param entity The entity the component belongs to
+	*/
+	void OnComponentEnabledChanged(std::type_index type, EntityIdType entity);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Update the queries and observers after an
+	 *        entity has been destroyed
+	 * @param entity The destroyed entity
+	*/
+	void OnEntityDestroyed(EntityIdType entity);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Start a new generation of an entity id (its
+	 *        entity is gone, the id may be handed out again)
+	 * @param entity The id
+	*/
+	void OnEntityIdReleased(EntityIdType entity);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Get the generation of an entity id, see
+	 *        Junia::GetEntityGeneration()
+	 * @param entity The id
+	 * @return How often the id has been released
+	*/
+	[[nodiscard]] uint32_t GetEntityGeneration(EntityIdType entity) const;
+
+	/**
+	 * @brief INTERNAL USE ONLY - Match the queries involving a component type
+	 *        and reset its observers (after its store has been replaced)
+	 * @param type The component type
+	*/
+	void OnStoreReplaced(std::type_index type);
+
+	/**
+	 * @brief INTERNAL USE ONLY - Match all queries and reset all observers
+	 *        (after the stores have been loaded)
+	*/
+	void OnStoresReplaced();
+
+#ifdef JUNIA_ECS_STATS
+	/**
+	 * @brief INTERNAL USE ONLY - Add a run of a system to its timings (thread
+	 *        safe)
+	 * @param name The name of the system
+	 * @param duration The time the run took
+	*/
+	void RecordSystemTime(const char* name, std::chrono::nanoseconds duration);
+#endif
+};
+
+// -----------------------------------------------------------------------------
+// ------------------------------ Implementations ------------------------------
+// -----------------------------------------------------------------------------
+
+// inline, resources are fetched by every system every frame
+inline void* World::FindResource(ResourceIdType id) const {
+	return id < resources.size() ? resources[id].value.get() : nullptr;
+}
+
+// inline, checked for every candidate when iterating queries
+inline bool World::IsEntityEnabled(EntityIdType entity) const {
+	return !disabledEntities.Test(entity);
+}
+
+} // namespace Junia
@@ -1,9 +1,31 @@
-#pragma once
-
-#include <type_traits>
-
-namespace Junia
-{
-	template<typename T, typename Base>
-	concept TypenameDerivedFrom = std::is_base_of<Base, T>::value;
-}
+#pragma once
+
+#include <concepts>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace Junia
+{
+	template<typename T, typename Base>
+	concept TypenameDerivedFrom = std::is_base_of<Base, T>::value;
+
+	template<typename T>
+	concept Serializable = std::default_initializable<T>
+		&& requires(const T& constValue, T& value, std::ostream& out, std::istream& in)
+	{
+		constValue.Serialize(out);
+		value.Deserialize(in);
+	};
+
+	/**
+	 * @brief Components declaring static constexpr bool SNAPSHOT_RAW_BYTES =
+	 *        true, promising that apart from the vtable pointer they are plain
+	 *        bytes (no pointers, handles or members needing destruction)
+	*/
+	template<typename T>
+	concept RawSnapshotComponent = requires
+	{
+		{ T::SNAPSHOT_RAW_BYTES } -> std::convertible_to<bool>;
+	} && static_cast<bool>(T::SNAPSHOT_RAW_BYTES);
+}
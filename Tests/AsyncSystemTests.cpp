@@ -0,0 +1,147 @@
+#include "AsyncSystem.hpp"
+#include "ECS.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Health : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	int value = 0;
+
+	Health() = default;
+
+	explicit Health(int value)
+		: value(value) { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Systems ----------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Counts the frames it has been resumed in, reading the health of an
+ *        entity across each suspension
+*/
+static Junia::AsyncSystem CountFrames(Junia::Entity entity, int& frames, int& lastHealth) {
+	Junia::ComponentRef<Health> health(entity);
+	while (true) {
+		co_await Junia::NextFrame(health);
+		frames++;
+		lastHealth = health->value;
+	}
+}
+
+/**
+ * @brief Runs a job that takes a while and stores its result
+*/
+static Junia::AsyncSystem RunSlowJob(std::atomic<bool>& finished, int& result) {
+	result = co_await Junia::Background([&finished]() -> int {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		finished = true;
+		return 42;
+	});
+}
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class AsyncSystemTest : public testing::Test {
+protected:
+	int frames = 0;
+	int lastHealth = 0;
+
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Health>();
+	}
+
+	static void EndFrame() {
+		Junia::World::GetActive()->EndFrame();
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(AsyncSystemTest, SystemsAreResumedEveryFrame) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Health>(3);
+	Junia::StartAsyncSystem(CountFrames(entity, frames, lastHealth));
+	EXPECT_EQ(frames, 0);
+
+	EndFrame();
+	entity.GetComponent<Health>().value = 2;
+	EndFrame();
+	EXPECT_EQ(frames, 2);
+	EXPECT_EQ(lastHealth, 2);
+}
+
+TEST_F(AsyncSystemTest, SystemsEndWhenTheirEntityIsDestroyedAndItsIdReused) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Health>(3);
+	Junia::StartAsyncSystem(CountFrames(entity, frames, lastHealth));
+
+	// the new entity gets the same id and a component of the same type
+	Junia::Entity::DestroyEntity(entity);
+	Junia::Entity reused = Junia::Entity::Create();
+	ASSERT_EQ(reused.GetId(), entity.GetId());
+	reused.AddComponent<Health>(7);
+
+	EndFrame();
+	EndFrame();
+	EXPECT_EQ(frames, 0);
+	EXPECT_EQ(Junia::World::GetActiveWorld().GetAsyncScheduler().GetCount(), 0U);
+}
+
+TEST_F(AsyncSystemTest, SystemsEndWhenALoadedSnapshotLacksTheirEntity) {
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Health>(3);
+	Junia::StartAsyncSystem(CountFrames(entity, frames, lastHealth));
+
+	Junia::LoadSnapshot(snapshot);
+	Junia::Entity::Create().AddComponent<Health>(7);
+	EndFrame();
+	EXPECT_EQ(frames, 0);
+}
+
+TEST_F(AsyncSystemTest, BackgroundJobsResumeWithTheirResult) {
+	std::atomic<bool> finished = false;
+	int result = 0;
+	Junia::StartAsyncSystem(RunSlowJob(finished, result));
+	EndFrame();
+	EXPECT_EQ(result, 0);
+
+	// resumed at the first frame boundary after the job has completed
+	while (result == 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		EndFrame();
+	}
+	EXPECT_TRUE(finished);
+	EXPECT_EQ(result, 42);
+}
+
+TEST_F(AsyncSystemTest, DestroyingTheWorldWaitsForBackgroundJobs) {
+	std::atomic<bool> finished = false;
+	int result = 0;
+	Junia::StartAsyncSystem(RunSlowJob(finished, result));
+
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	EXPECT_TRUE(finished);
+	EXPECT_EQ(result, 0);
+}
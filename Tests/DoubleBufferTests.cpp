@@ -0,0 +1,165 @@
+#include "ComponentObserver.hpp"
+#include "ECS.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Counts its live instances and copies (every component is destroyed
+ *        exactly once if the live count balances out)
+*/
+class Buffered : public Junia::Component {
+public:
+	static inline int live = 0;
+	static inline int copies = 0;
+
+	int value = 0;
+
+	Buffered() {
+		live++;
+	}
+
+	explicit Buffered(int value)
+		: value(value) {
+		live++;
+	}
+
+	Buffered(const Buffered& other)
+		: Component(other), value(other.value) {
+		live++;
+		copies++;
+	}
+
+	~Buffered() override {
+		live--;
+	}
+};
+
+/**
+ * @brief Ignores all changes (only makes the store track them)
+*/
+class IgnoringObserver : public Junia::ComponentObserver {
+public:
+	void OnComponentChanged(const void* /*component*/) override { }
+
+	void OnComponentRemoved(Junia::EntityIdType /*entity*/) override { }
+
+	void OnComponentsCleared() override { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class DoubleBufferTest : public testing::Test {
+protected:
+	static constexpr int ENTITY_COUNT = 4096;
+
+	std::vector<Junia::Entity> entities{ };
+
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Buffered>();
+		for (int i = 0; i < ENTITY_COUNT; i++) {
+			entities.push_back(Junia::Entity::Create());
+			entities.back().AddComponent<Buffered>(i);
+		}
+		Junia::Component::SetDoubleBuffered<Buffered>();
+	}
+
+	void TearDown() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		EXPECT_EQ(Buffered::live, 0);
+	}
+
+	/**
+	 * @brief Sum the components as seen by reads
+	*/
+	[[nodiscard]] long long SumReads() const {
+		long long sum = 0;
+		for (const Junia::Entity& entity : entities) sum += entity.ReadComponent<Buffered>().value;
+		return sum;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(DoubleBufferTest, ReadsSeeTheLastFrame) {
+	entities[0].GetComponent<Buffered>().value = -1;
+	EXPECT_EQ(entities[0].ReadComponent<Buffered>().value, 0);
+	EXPECT_EQ(entities[0].GetComponent<Buffered>().value, -1);
+
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_EQ(entities[0].ReadComponent<Buffered>().value, -1);
+	EXPECT_EQ(entities[1].ReadComponent<Buffered>().value, 1);
+}
+
+TEST_F(DoubleBufferTest, FrameBoundariesOnlyCopyWrittenPages) {
+	Junia::World::GetActive()->EndFrame();
+	Buffered::copies = 0;
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_EQ(Buffered::copies, 0);
+
+	entities[0].GetComponent<Buffered>().value = -1;
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_GT(Buffered::copies, 0);
+	EXPECT_LT(Buffered::copies, ENTITY_COUNT / 2);
+	EXPECT_EQ(entities[0].ReadComponent<Buffered>().value, -1);
+}
+
+TEST_F(DoubleBufferTest, AddedAndRemovedComponentsReachTheReadBuffer) {
+	// a slot taken and freed again within a frame, behind a live one
+	Junia::Entity transient = Junia::Entity::Create();
+	transient.AddComponent<Buffered>(-1);
+	Junia::Entity added = Junia::Entity::Create();
+	added.AddComponent<Buffered>(-2);
+	transient.RemoveComponent<Buffered>();
+	entities[5].RemoveComponent<Buffered>();
+	EXPECT_EQ(added.ReadComponent<Buffered>().value, -2);
+	Junia::World::GetActive()->EndFrame();
+
+	EXPECT_EQ(added.ReadComponent<Buffered>().value, -2);
+	EXPECT_FALSE(entities[5].HasComponent<Buffered>());
+	entities[5].AddComponent<Buffered>(-5);
+	Junia::World::GetActive()->EndFrame();
+
+	EXPECT_EQ(entities[5].ReadComponent<Buffered>().value, -5);
+	EXPECT_EQ(entities[7].ReadComponent<Buffered>().value, 7);
+	EXPECT_EQ(Buffered::live, (ENTITY_COUNT + 1) * 2);
+}
+
+TEST_F(DoubleBufferTest, ParallelReadsAndWritesOfTheSameType) {
+	// the writers record their changes as well
+	Junia::RegisterComponentObserver(typeid(Buffered), std::make_shared<IgnoringObserver>());
+	Junia::FlushComponentChanges(typeid(Buffered));
+	const long long before = SumReads();
+
+	// two writers on interleaved components (sharing every page) and a reader
+	const auto write = [this](int first) -> void {
+		for (size_t i = first; i < entities.size(); i += 2) entities[i].GetComponent<Buffered>().value++;
+	};
+	long long during = 0;
+	std::thread reader([this, &during]() -> void {
+		for (int pass = 0; pass < 4; pass++) during = std::max(during, SumReads());
+	});
+	std::thread evenWriter(write, 0);
+	std::thread oddWriter(write, 1);
+	reader.join();
+	evenWriter.join();
+	oddWriter.join();
+
+	EXPECT_EQ(during, before);
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_EQ(SumReads(), before + ENTITY_COUNT);
+}
@@ -0,0 +1,134 @@
+#include "Events.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Events -----------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Counts its live instances, which only balances out if every event
+ *        is destroyed exactly once
+*/
+struct Hit {
+	static inline int live = 0;
+
+	int damage = 0;
+
+	explicit Hit(int damage)
+		: damage(damage) {
+		live++;
+	}
+
+	Hit(const Hit& other)
+		: damage(other.damage) {
+		live++;
+	}
+
+	Hit(Hit&&) = delete;
+	Hit& operator=(const Hit&) = delete;
+	Hit& operator=(Hit&&) = delete;
+
+	~Hit() {
+		live--;
+	}
+};
+
+/**
+ * @brief A trivial event (sent from many threads at once)
+*/
+struct Ping {
+	int value = 0;
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class EventTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+	}
+
+	void TearDown() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		EXPECT_EQ(Hit::live, 0);
+	}
+
+	/**
+	 * @brief Read the events a reader has not read yet
+	*/
+	static std::vector<int> ReadAll(Junia::EventReader<Hit>& reader) {
+		std::vector<int> damages{ };
+		reader.Read([&damages](const Hit& hit) -> void {
+			damages.push_back(hit.damage);
+		});
+		return damages;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(EventTest, EventsAreReadOncePerReader) {
+	Junia::Events<Hit> events{ };
+	Junia::EventReader<Hit> first = events.CreateReader();
+	Junia::EventReader<Hit> second = events.CreateReader();
+	events.Send(1);
+	events.Send(2);
+
+	EXPECT_EQ(ReadAll(first), (std::vector<int>{ 1, 2 }));
+	EXPECT_TRUE(ReadAll(first).empty());
+	events.Send(3);
+	EXPECT_EQ(ReadAll(first), (std::vector<int>{ 3 }));
+	EXPECT_EQ(ReadAll(second), (std::vector<int>{ 1, 2, 3 }));
+}
+
+TEST_F(EventTest, EventsAreDroppedTwoFramesAfterBeingSent) {
+	Junia::Events<Hit> events{ };
+	Junia::EventReader<Hit> reader = events.CreateReader();
+	events.Send(1);
+	Junia::World::GetActive()->EndFrame();
+	events.Send(2);
+	EXPECT_EQ(Hit::live, 2);
+
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_EQ(Hit::live, 1);
+	EXPECT_EQ(ReadAll(reader), (std::vector<int>{ 2 }));
+	Junia::World::GetActive()->EndFrame();
+	EXPECT_EQ(Hit::live, 0);
+}
+
+TEST_F(EventTest, ThreadsBeyondTheSlotCountShareTheOverflowSlot) {
+	Junia::Events<Ping> events{ };
+	Junia::EventReader<Ping> reader = events.CreateReader();
+
+	// every thread holds on to its slot (taken by the first event) until all
+	// have sent one, so the last ones find every slot taken
+	constexpr int EVENTS_PER_THREAD = 100;
+	const size_t threadCount = Junia::EVENT_THREAD_SLOTS + 8;
+	std::latch sent(static_cast<std::ptrdiff_t>(threadCount));
+	std::vector<std::thread> threads{ };
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.emplace_back([&events, &sent]() -> void {
+			events.Send(1);
+			sent.arrive_and_wait();
+			for (int j = 1; j < EVENTS_PER_THREAD; j++) events.Send(1);
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	int sum = 0;
+	reader.Read([&sum](const Ping& ping) -> void {
+		sum += ping.value;
+	});
+	EXPECT_EQ(sum, static_cast<int>(threadCount) * EVENTS_PER_THREAD);
+}
@@ -0,0 +1,128 @@
+#include "ECS.hpp"
+#include "Hierarchy.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class HierarchyTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+	}
+
+	/**
+	 * @brief Get the ids of the children of an entity in order
+	*/
+	static std::vector<Junia::EntityIdType> GetChildIds(Junia::Entity entity) {
+		std::vector<Junia::EntityIdType> ids{ };
+		for (const Junia::Entity child : entity.GetChildren()) ids.push_back(child.GetId());
+		return ids;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(HierarchyTest, SnapshotRestoresChildrenInOrder) {
+	std::vector<Junia::Entity> parents{ };
+	for (int i = 0; i < 8; i++) parents.push_back(Junia::Entity::Create());
+	std::vector<Junia::Entity> children{ };
+	for (int i = 0; i < 200; i++) children.push_back(Junia::Entity::Create());
+	// attached back to front, so the child order differs from the id order
+	for (size_t i = children.size(); i-- > 0;) children[i].SetParent(parents[i % parents.size()]);
+	parents[1].SetParent(parents[0]);
+
+	std::vector<std::vector<Junia::EntityIdType>> expected{ };
+	for (const Junia::Entity parent : parents) expected.push_back(GetChildIds(parent));
+	const std::vector<Junia::EntityIdType> expectedOrder = Junia::GetHierarchyOrder().entities;
+
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+	children[0].RemoveParent();
+	children[5].SetParent(parents[7]);
+	Junia::LoadSnapshot(snapshot);
+
+	for (size_t i = 0; i < parents.size(); i++) EXPECT_EQ(GetChildIds(parents[i]), expected[i]);
+	EXPECT_EQ(Junia::GetHierarchyOrder().entities, expectedOrder);
+}
+
+TEST_F(HierarchyTest, SetParentRejectsEntitiesThatDoNotExist) {
+	Junia::Entity child = Junia::Entity::Create();
+	Junia::Entity destroyed = Junia::Entity::Create();
+	Junia::Entity::Create();
+	Junia::Entity::DestroyEntity(destroyed);
+
+	EXPECT_THROW(child.SetParent(destroyed), std::runtime_error);
+	EXPECT_THROW(destroyed.SetParent(child), std::runtime_error);
+	EXPECT_THROW(static_cast<void>(Junia::Entity::Get(destroyed.GetId())), std::runtime_error);
+	EXPECT_THROW(static_cast<void>(Junia::Entity::Get(1000)), std::runtime_error);
+	EXPECT_FALSE(child.HasParent());
+	EXPECT_EQ(Junia::Entity::Get(child.GetId()).GetId(), child.GetId());
+}
+
+TEST_F(HierarchyTest, SetParentRejectsCycles) {
+	Junia::Entity root = Junia::Entity::Create();
+	Junia::Entity child = Junia::Entity::Create();
+	Junia::Entity grandchild = Junia::Entity::Create();
+	child.SetParent(root);
+	grandchild.SetParent(child);
+
+	EXPECT_THROW(root.SetParent(grandchild), std::runtime_error);
+	EXPECT_THROW(root.SetParent(root), std::runtime_error);
+	EXPECT_FALSE(root.HasParent());
+}
+
+TEST_F(HierarchyTest, OrderListsParentsBeforeChildren) {
+	Junia::Entity root = Junia::Entity::Create();
+	Junia::Entity child = Junia::Entity::Create();
+	Junia::Entity grandchild = Junia::Entity::Create();
+	grandchild.SetParent(child);
+	child.SetParent(root);
+
+	const Junia::HierarchyOrder& order = Junia::GetHierarchyOrder();
+	ASSERT_EQ(order.entities.size(), 3U);
+	EXPECT_EQ(order.entities, (std::vector<Junia::EntityIdType>{ root.GetId(), child.GetId(), grandchild.GetId() }));
+	EXPECT_EQ(order.parents[0], Junia::HIERARCHY_NO_PARENT);
+	EXPECT_EQ(order.parents[2], 1U);
+	EXPECT_EQ(order.depths[2], 2U);
+}
+
+TEST_F(HierarchyTest, DestroyingAnEntityDestroysItsDescendants) {
+	Junia::Entity root = Junia::Entity::Create();
+	Junia::Entity child = Junia::Entity::Create();
+	Junia::Entity grandchild = Junia::Entity::Create();
+	Junia::Entity sibling = Junia::Entity::Create();
+	child.SetParent(root);
+	grandchild.SetParent(child);
+	sibling.SetParent(root);
+
+	Junia::Entity::DestroyEntity(child);
+	EXPECT_THROW(static_cast<void>(Junia::Entity::Get(grandchild.GetId())), std::runtime_error);
+	EXPECT_EQ(GetChildIds(root), std::vector<Junia::EntityIdType>{ sibling.GetId() });
+}
+
+TEST_F(HierarchyTest, DestroyingAnEntityTwiceThrows) {
+	Junia::Entity parent = Junia::Entity::Create();
+	Junia::Entity child = Junia::Entity::Create();
+	Junia::Entity::Create();
+	child.SetParent(parent);
+	Junia::Entity::DestroyEntity(parent);
+
+	// a second free would hand the same id out to two entities
+	EXPECT_THROW(Junia::Entity::DestroyEntity(parent), std::runtime_error);
+	EXPECT_THROW(Junia::Entity::DestroyEntity(child), std::runtime_error);
+	const Junia::Entity first = Junia::Entity::Create();
+	const Junia::Entity second = Junia::Entity::Create();
+	EXPECT_NE(first.GetId(), second.GetId());
+	EXPECT_EQ(Junia::World::GetActive()->GetStats().entities.freeCount, 0U);
+}
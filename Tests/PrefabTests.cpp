@@ -0,0 +1,159 @@
+#include "ECS.hpp"
+#include "Prefab.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Health : public Junia::Component {
+public:
+	int value = 0;
+
+	Health() = default;
+
+	explicit Health(int value)
+		: value(value) { }
+};
+
+/**
+ * @brief Counts its live instances and throws from the copy constructor once
+ *        a set amount of copies has been made (never if negative)
+*/
+class Fragile : public Junia::Component {
+public:
+	static inline int live = 0;
+	static inline int copiesLeft = -1;
+
+	Fragile() {
+		live++;
+	}
+
+	Fragile(const Fragile& other)
+		: Component(other) {
+		if (copiesLeft-- == 0) throw std::runtime_error("copy failed");
+		live++;
+	}
+
+	~Fragile() override {
+		live--;
+	}
+};
+
+class Label : public Junia::Component {
+public:
+	std::string text{ };
+
+	Label() = default;
+
+	explicit Label(std::string text)
+		: text(std::move(text)) { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class PrefabTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Health>();
+		Junia::Component::Register<Label>();
+	}
+
+	/**
+	 * @brief Get the statistics of the store of a component type
+	*/
+	static Junia::ComponentStoreStats GetStoreStats(std::type_index type) {
+		for (const Junia::ComponentStoreStats& store : Junia::World::GetActive()->GetStats().stores) {
+			if (store.typeName == type.name()) return store;
+		}
+		return { };
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(PrefabTest, InstantiateCopiesEveryComponent) {
+	Junia::Prefab prefab{ };
+	prefab.AddComponent<Health>(100).AddComponent<Label>("a label long enough to be allocated on the heap");
+
+	std::vector<Junia::Entity> entities = prefab.Instantiate(5000);
+	ASSERT_EQ(entities.size(), 5000U);
+	for (Junia::Entity entity : entities) {
+		EXPECT_EQ(entity.ReadComponent<Health>().value, 100);
+		EXPECT_EQ(entity.ReadComponent<Health>().GetEntity().GetId(), entity.GetId());
+		EXPECT_EQ(entity.ReadComponent<Label>().text, "a label long enough to be allocated on the heap");
+	}
+
+	// the copies are independent of each other
+	entities[0].GetComponent<Label>().text = "changed";
+	EXPECT_EQ(entities[1].ReadComponent<Label>().text, "a label long enough to be allocated on the heap");
+}
+
+TEST_F(PrefabTest, AddingATypeAgainReplacesIt) {
+	Junia::Prefab prefab{ };
+	prefab.AddComponent<Health>(1).AddComponent<Health>(2);
+
+	const Junia::Entity entity = prefab.Instantiate();
+	EXPECT_EQ(entity.ReadComponent<Health>().value, 2);
+	EXPECT_FALSE(entity.HasComponent<Label>());
+}
+
+TEST_F(PrefabTest, InstancesFillSlotsFreedBefore) {
+	Junia::Prefab prefab{ };
+	prefab.AddComponent<Health>(3);
+
+	std::vector<Junia::Entity> first = prefab.Instantiate(10);
+	for (size_t i = 0; i < first.size(); i += 2) Junia::Entity::DestroyEntity(first[i]);
+
+	const Junia::ComponentStoreStats before = GetStoreStats(typeid(Health));
+	ASSERT_EQ(before.holeCount, 5U);
+
+	// half of the instances fill the holes, the rest is appended
+	const std::vector<Junia::Entity> second = prefab.Instantiate(10);
+	const Junia::ComponentStoreStats after = GetStoreStats(typeid(Health));
+	EXPECT_EQ(after.holeCount, 0U);
+	EXPECT_EQ(after.liveCount, 15U);
+	EXPECT_EQ(after.capacity, before.capacity);
+	for (Junia::Entity entity : second) EXPECT_EQ(entity.ReadComponent<Health>().value, 3);
+	for (size_t i = 1; i < first.size(); i += 2) EXPECT_EQ(first[i].ReadComponent<Health>().value, 3);
+}
+
+TEST_F(PrefabTest, AFailingCopyLeavesNoComponentsBehind) {
+	Junia::Component::Register<Fragile>();
+	Junia::Prefab prefab{ };
+	prefab.AddComponent<Health>(3).AddComponent<Fragile>();
+	const std::vector<Junia::Entity> existing = prefab.Instantiate(1000);
+	for (size_t i = 0; i < existing.size(); i += 3) Junia::Entity::DestroyEntity(existing[i]);
+	const int liveBefore = Fragile::live;
+
+	// fails after filling the holes, in the middle of the appended run
+	Fragile::copiesLeft = 500;
+	EXPECT_THROW(static_cast<void>(prefab.Instantiate(1000)), std::runtime_error);
+	EXPECT_EQ(Fragile::live, liveBefore);
+	const Junia::WorldStats stats = Junia::World::GetActive()->GetStats();
+	EXPECT_EQ(stats.entities.liveCount, existing.size() - 334);
+	EXPECT_EQ(GetStoreStats(typeid(Health)).liveCount, existing.size() - 334);
+	EXPECT_EQ(GetStoreStats(typeid(Fragile)).liveCount, existing.size() - 334);
+	// the last slot was freed at the end of the store instead of leaving a hole
+	EXPECT_EQ(GetStoreStats(typeid(Fragile)).holeCount, 333U);
+
+	Fragile::copiesLeft = -1;
+	const std::vector<Junia::Entity> instances = prefab.Instantiate(10);
+	EXPECT_EQ(Fragile::live, liveBefore + 10);
+	// only the prototype of the prefab is left
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	EXPECT_EQ(Fragile::live, 1);
+}
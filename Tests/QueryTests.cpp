@@ -0,0 +1,170 @@
+#include "ECS.hpp"
+#include "Query.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Speed : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	float value = 0.0F;
+};
+
+class Fuel : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	float value = 1.0F;
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class QueryTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Speed>();
+		Junia::Component::Register<Fuel>();
+	}
+
+	/**
+	 * @brief Get the matches of a query sorted by id
+	*/
+	template<typename TQuery>
+	static std::vector<Junia::EntityIdType> GetSorted(const TQuery& query) {
+		std::vector<Junia::EntityIdType> entities = query.GetEntities();
+		std::sort(entities.begin(), entities.end());
+		return entities;
+	}
+
+	/**
+	 * @brief Get the entities ForEach() visits sorted by id
+	*/
+	template<typename... T>
+	static std::vector<Junia::EntityIdType> GetVisited(Junia::Query<T...>& query) {
+		std::vector<Junia::EntityIdType> entities{ };
+		query.ForEach([&entities](Junia::Entity entity, T&... /*components*/) -> void {
+			entities.push_back(entity.GetId());
+		});
+		std::sort(entities.begin(), entities.end());
+		return entities;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(QueryTest, MatchesExistingAndFollowsStructuralChanges) {
+	Junia::Entity both = Junia::Entity::Create();
+	both.AddComponent<Speed>();
+	both.AddComponent<Fuel>();
+	Junia::Entity speedOnly = Junia::Entity::Create();
+	speedOnly.AddComponent<Speed>();
+
+	const Junia::Query<Speed, Fuel> query{ };
+	EXPECT_EQ(GetSorted(query), std::vector<Junia::EntityIdType>{ both.GetId() });
+
+	speedOnly.AddComponent<Fuel>();
+	EXPECT_EQ(GetSorted(query), (std::vector<Junia::EntityIdType>{ both.GetId(), speedOnly.GetId() }));
+
+	both.RemoveComponent<Speed>();
+	EXPECT_EQ(GetSorted(query), std::vector<Junia::EntityIdType>{ speedOnly.GetId() });
+
+	Junia::Entity::DestroyEntity(speedOnly);
+	EXPECT_EQ(query.Size(), 0U);
+}
+
+TEST_F(QueryTest, ForEachVisitsEveryMatchWhileRemovingTheCurrentOne) {
+	for (int i = 0; i < 200; i++) {
+		Junia::Entity entity = Junia::Entity::Create();
+		entity.AddComponent<Speed>().value = static_cast<float>(i);
+		if (i % 3 != 0) entity.AddComponent<Fuel>();
+	}
+
+	Junia::Query<Speed, Fuel> query{ };
+	const size_t matches = query.Size();
+	size_t visited = 0;
+	query.ForEach([&visited](Junia::Entity entity, Speed& speed, Fuel& /*fuel*/) -> void {
+		EXPECT_NE(static_cast<int>(speed.value) % 3, 0);
+		entity.RemoveComponent<Fuel>();
+		visited++;
+	});
+	EXPECT_EQ(visited, matches);
+	EXPECT_EQ(query.Size(), 0U);
+}
+
+TEST_F(QueryTest, SnapshotLoadsRebuildTheMatches) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Speed>();
+	entity.AddComponent<Fuel>();
+	const Junia::Query<Speed, Fuel> query{ };
+
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+	entity.RemoveComponent<Fuel>();
+	EXPECT_EQ(query.Size(), 0U);
+
+	Junia::LoadSnapshot(snapshot);
+	EXPECT_EQ(GetSorted(query), std::vector<Junia::EntityIdType>{ entity.GetId() });
+}
+
+TEST_F(QueryTest, QueriesStayWithTheirWorld) {
+	const Junia::Query<Speed> query{ };
+	const std::shared_ptr<Junia::World> original = Junia::World::GetActive();
+	Junia::World::SetActive(original->Fork());
+	Junia::Entity::Create().AddComponent<Speed>();
+	EXPECT_EQ(query.Size(), 0U);
+
+	Junia::World::SetActive(original);
+	Junia::Entity::Create().AddComponent<Speed>();
+	EXPECT_EQ(query.Size(), 1U);
+}
+
+TEST_F(QueryTest, ForEachSkipsDisabledEntitiesAndComponents) {
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 3; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Speed>();
+		entities.back().AddComponent<Fuel>();
+	}
+	Junia::Query<Speed, Fuel> both{ };
+	Junia::Query<Speed> speed{ };
+
+	entities[0].SetEnabled(false);
+	entities[1].SetComponentEnabled<Fuel>(false);
+	EXPECT_EQ(GetVisited(both), std::vector<Junia::EntityIdType>{ entities[2].GetId() });
+	EXPECT_EQ(GetVisited(speed), (std::vector<Junia::EntityIdType>{ entities[1].GetId(), entities[2].GetId() }));
+	EXPECT_EQ(both.Size(), 3U);
+
+	entities[0].SetEnabled(true);
+	entities[1].SetComponentEnabled<Fuel>(true);
+	EXPECT_EQ(GetVisited(both), GetSorted(both));
+	EXPECT_EQ(GetVisited(speed), GetSorted(speed));
+}
+
+TEST_F(QueryTest, EntitiesDisabledBeforeMatchingAreSkipped) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Speed>();
+	Junia::Query<Speed, Fuel> query{ };
+	entity.SetEnabled(false);
+
+	entity.AddComponent<Fuel>();
+	EXPECT_EQ(query.Size(), 1U);
+	EXPECT_TRUE(GetVisited(query).empty());
+
+	entity.SetEnabled(true);
+	EXPECT_EQ(GetVisited(query), std::vector<Junia::EntityIdType>{ entity.GetId() });
+}
@@ -0,0 +1,110 @@
+#include "ComponentObserver.hpp"
+#include "ECS.hpp"
+#include "Resource.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <typeinfo>
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Helpers ----------------------------------
+// -----------------------------------------------------------------------------
+
+struct FrameTime {
+	float delta = 0.0F;
+
+	FrameTime() = default;
+
+	explicit FrameTime(float delta)
+		: delta(delta) { }
+};
+
+/**
+ * @brief A resource that can not be copied, so forks share it
+*/
+struct SharedLock {
+	std::mutex mutex{ };
+};
+
+class Observed : public Junia::Component {
+public:
+	int value = 0;
+};
+
+/**
+ * @brief Counts the changes reported to it
+*/
+class CountingObserver : public Junia::ComponentObserver {
+public:
+	int changed = 0;
+
+	void OnComponentChanged(const void* /*component*/) override {
+		changed++;
+	}
+
+	void OnComponentRemoved(Junia::EntityIdType /*entity*/) override { }
+
+	void OnComponentsCleared() override { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class ResourceTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(ResourceTest, SetGetAndRemove) {
+	EXPECT_FALSE(Junia::HasResource<FrameTime>());
+	EXPECT_THROW(static_cast<void>(Junia::GetResource<FrameTime>()), std::runtime_error);
+
+	Junia::SetResource<FrameTime>(0.5F);
+	EXPECT_TRUE(Junia::HasResource<FrameTime>());
+	Junia::GetResource<FrameTime>().delta = 0.25F;
+	EXPECT_EQ(Junia::ReadResource<FrameTime>().delta, 0.25F);
+
+	Junia::SetResource<FrameTime>(1.0F);
+	EXPECT_EQ(Junia::ReadResource<FrameTime>().delta, 1.0F);
+
+	Junia::RemoveResource<FrameTime>();
+	EXPECT_FALSE(Junia::HasResource<FrameTime>());
+}
+
+TEST_F(ResourceTest, ForksCopyCopyableResourcesAndShareTheOthers) {
+	Junia::SetResource<FrameTime>(0.5F);
+	SharedLock& lock = Junia::SetResource<SharedLock>();
+	const std::shared_ptr<Junia::World> original = Junia::World::GetActive();
+
+	Junia::World::SetActive(original->Fork());
+	Junia::GetResource<FrameTime>().delta = 2.0F;
+	EXPECT_EQ(&Junia::GetResource<SharedLock>(), &lock);
+
+	Junia::World::SetActive(original);
+	EXPECT_EQ(Junia::ReadResource<FrameTime>().delta, 0.5F);
+}
+
+TEST_F(ResourceTest, ObserversOfUnregisteredTypesAreRejectedBeforeRegistering) {
+	const auto observer = std::make_shared<CountingObserver>();
+	EXPECT_THROW(Junia::RegisterComponentObserver(typeid(Observed), observer), std::out_of_range);
+
+	Junia::Component::Register<Observed>();
+	Junia::Entity::Create().AddComponent<Observed>();
+	Junia::FlushComponentChanges(typeid(Observed));
+	EXPECT_EQ(observer->changed, 0);
+
+	Junia::RegisterComponentObserver(typeid(Observed), observer);
+	Junia::FlushComponentChanges(typeid(Observed));
+	EXPECT_EQ(observer->changed, 1);
+}
@@ -0,0 +1,362 @@
+#include "ECS.hpp"
+#include "Serialization.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class RawPosition : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	float x = 0.0F;
+	float y = 0.0F;
+
+	RawPosition() = default;
+
+	RawPosition(float x, float y)
+		: x(x), y(y) { }
+};
+
+class Name : public Junia::Component {
+public:
+	std::string value{ };
+
+	Name() = default;
+
+	explicit Name(std::string value)
+		: value(std::move(value)) { }
+
+	void Serialize(std::ostream& stream) const {
+		stream << value;
+	}
+
+	void Deserialize(std::istream& stream) {
+		stream >> value;
+		if (value == "corrupted") throw std::runtime_error("corrupted name");
+	}
+};
+
+/**
+ * @brief Counts its live instances, which only balances out if every
+ *        destroyed component has been constructed before
+*/
+class Tracked : public Junia::Component {
+public:
+	static constexpr bool SNAPSHOT_RAW_BYTES = true;
+
+	static inline int live = 0;
+
+	int value = 0;
+
+	Tracked() {
+		live++;
+	}
+
+	explicit Tracked(int value)
+		: value(value) {
+		live++;
+	}
+
+	Tracked(const Tracked& other)
+		: Component(other), value(other.value) {
+		live++;
+	}
+
+	~Tracked() override {
+		live--;
+	}
+};
+
+class Plain : public Junia::Component {
+public:
+	int value = 0;
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class SnapshotTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<RawPosition>();
+		Junia::Component::Register<Name>();
+	}
+};
+
+/**
+ * @brief Write a snapshot of the active world to a file that is removed again
+ *        at the end of the test
+*/
+class SnapshotFile {
+public:
+	std::filesystem::path path = std::filesystem::temp_directory_path()
+		/ ("junia_snapshot_" + std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+
+	SnapshotFile() {
+		std::ofstream stream(path, std::ios::binary);
+		Junia::SaveSnapshot(stream);
+	}
+
+	~SnapshotFile() {
+		std::filesystem::remove(path);
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(SnapshotTest, RoundTripRestoresComponentsAndEntities) {
+	Junia::Entity first = Junia::Entity::Create();
+	Junia::Entity second = Junia::Entity::Create();
+	first.AddComponent<RawPosition>(1.0F, 2.0F);
+	first.AddComponent<Name>("first");
+	second.AddComponent<RawPosition>(3.0F, 4.0F);
+	second.SetParent(first);
+	Junia::Entity third = Junia::Entity::Create();
+	third.AddComponent<Name>("third");
+
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+
+	first.GetComponent<RawPosition>().x = 10.0F;
+	first.GetComponent<Name>().value = "changed";
+	second.RemoveComponent<RawPosition>();
+	second.RemoveParent();
+	Junia::Entity::Create().AddComponent<Name>("added");
+
+	Junia::LoadSnapshot(snapshot);
+
+	EXPECT_EQ(first.GetComponent<RawPosition>().x, 1.0F);
+	EXPECT_EQ(first.GetComponent<RawPosition>().y, 2.0F);
+	EXPECT_EQ(first.GetComponent<RawPosition>().GetEntity().GetId(), first.GetId());
+	EXPECT_EQ(first.GetComponent<Name>().value, "first");
+	ASSERT_TRUE(second.HasComponent<RawPosition>());
+	EXPECT_EQ(second.GetComponent<RawPosition>().x, 3.0F);
+	EXPECT_FALSE(second.HasComponent<Name>());
+	ASSERT_TRUE(second.HasParent());
+	EXPECT_EQ(second.GetParent().GetId(), first.GetId());
+	// components constructed by their hooks know their entity
+	EXPECT_EQ(third.GetComponent<Name>().value, "third");
+	EXPECT_EQ(third.GetComponent<Name>().GetEntity().GetId(), third.GetId());
+	// the entity created after saving is handed out again
+	EXPECT_EQ(Junia::Entity::Create().GetId(), third.GetId() + 1);
+}
+
+TEST_F(SnapshotTest, TruncatedSnapshotLeavesWorldUntouched) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<RawPosition>(1.0F, 2.0F);
+	entity.AddComponent<Name>("saved");
+
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+	std::string bytes = snapshot.str();
+	bytes.resize(bytes.size() - 1);
+
+	entity.GetComponent<RawPosition>().x = 5.0F;
+	entity.GetComponent<Name>().value = "current";
+
+	std::istringstream truncated(bytes);
+	EXPECT_THROW(Junia::LoadSnapshot(truncated), std::runtime_error);
+	EXPECT_EQ(entity.GetComponent<RawPosition>().x, 5.0F);
+	EXPECT_EQ(entity.GetComponent<Name>().value, "current");
+}
+
+TEST_F(SnapshotTest, FailingDeserializeLeavesWorldUntouched) {
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 3; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<RawPosition>(static_cast<float>(i), 0.0F);
+		entities.back().AddComponent<Name>(i == 2 ? "corrupted" : "valid");
+	}
+
+	std::stringstream snapshot{ };
+	Junia::SaveSnapshot(snapshot);
+	for (Junia::Entity entity : entities) entity.GetComponent<RawPosition>().y = 7.0F;
+
+	EXPECT_THROW(Junia::LoadSnapshot(snapshot), std::runtime_error);
+	for (Junia::Entity entity : entities) {
+		EXPECT_EQ(entity.GetComponent<RawPosition>().y, 7.0F);
+		EXPECT_TRUE(entity.HasComponent<Name>());
+	}
+}
+
+TEST_F(SnapshotTest, SavingTypeWithoutOptInThrowsBeforeWriting) {
+	Junia::Component::Register<Plain>();
+	Junia::Entity::Create().AddComponent<Plain>();
+
+	std::stringstream snapshot{ };
+	EXPECT_THROW(Junia::SaveSnapshot(snapshot), std::runtime_error);
+	EXPECT_TRUE(snapshot.str().empty());
+}
+
+TEST(BinaryReaderTest, HugeVectorCountThrowsInsteadOfAllocating) {
+	std::stringstream stream{ };
+	Junia::BinaryWriter writer(stream);
+	writer.Write<uint64_t>(std::numeric_limits<uint64_t>::max() / sizeof(uint64_t));
+	writer.Write<uint64_t>(1);
+
+	Junia::BinaryReader reader(stream);
+	EXPECT_THROW(reader.ReadVector<uint64_t>(), std::runtime_error);
+}
+
+TEST(BinaryReaderTest, HugeStringLengthThrowsInsteadOfAllocating) {
+	std::stringstream stream{ };
+	Junia::BinaryWriter writer(stream);
+	writer.Write<uint64_t>(std::numeric_limits<uint64_t>::max());
+
+	Junia::BinaryReader reader(stream);
+	EXPECT_THROW(reader.ReadString(), std::runtime_error);
+}
+
+TEST_F(SnapshotTest, MappedLoadConstructsSerializedComponents) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<Name>("mapped");
+	entity.AddComponent<RawPosition>(1.0F, 2.0F);
+	const SnapshotFile file{ };
+	entity.GetComponent<Name>().value = "changed";
+
+	Junia::LoadSnapshotMapped(file.path.string());
+	EXPECT_EQ(entity.GetComponent<Name>().value, "mapped");
+	EXPECT_EQ(entity.ReadComponent<RawPosition>().y, 2.0F);
+	entity.GetComponent<Name>().value = "written after loading";
+	entity.RemoveComponent<Name>();
+	EXPECT_FALSE(entity.HasComponent<Name>());
+}
+
+TEST_F(SnapshotTest, MappedRawComponentsAreNeverDestroyedWithoutConstruction) {
+	Junia::Component::Register<Tracked>();
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 3; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Tracked>(i);
+	}
+	const SnapshotFile file{ };
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	ASSERT_EQ(Tracked::live, 0);
+
+	Junia::Component::Register<RawPosition>();
+	Junia::Component::Register<Name>();
+	Junia::Component::Register<Tracked>();
+	Junia::LoadSnapshotMapped(file.path.string());
+	EXPECT_EQ(entities[1].ReadComponent<Tracked>().value, 1);
+
+	// writing copies the page, which constructs its components
+	entities[1].GetComponent<Tracked>().value = 10;
+	EXPECT_EQ(entities[0].ReadComponent<Tracked>().value, 0);
+	EXPECT_EQ(entities[1].ReadComponent<Tracked>().value, 10);
+	entities[2].RemoveComponent<Tracked>();
+
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST_F(SnapshotTest, TruncatedMappedSnapshotLeavesWorldUntouched) {
+	// the raw data block of the only store ends the file
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	Junia::Component::Register<Tracked>();
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 3; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Tracked>(i);
+	}
+	const SnapshotFile file{ };
+	std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+	entities[1].GetComponent<Tracked>().value = 10;
+
+	EXPECT_THROW(Junia::LoadSnapshotMapped(file.path.string()), std::runtime_error);
+	EXPECT_EQ(entities[1].GetComponent<Tracked>().value, 10);
+	EXPECT_EQ(entities[2].ReadComponent<Tracked>().value, 2);
+
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST_F(SnapshotTest, DeltaRoundTripReproducesChanges) {
+	Junia::Component::Register<Tracked>();
+	// keeps entity 0 out of the checks for the entity of each component
+	Junia::Entity::Create();
+	Junia::Entity kept = Junia::Entity::Create();
+	Junia::Entity removed = Junia::Entity::Create();
+	kept.AddComponent<RawPosition>(1.0F, 2.0F);
+	kept.AddComponent<Name>("a_name_long_enough_to_be_allocated_on_the_heap");
+	kept.AddComponent<Tracked>(1);
+	removed.AddComponent<RawPosition>(3.0F, 4.0F);
+
+	std::stringstream baseline{ };
+	Junia::SaveSnapshot(baseline);
+	const std::string baselineBytes = baseline.str();
+
+	kept.GetComponent<RawPosition>().y = 20.0F;
+	kept.GetComponent<Name>().value = "another_name_long_enough_to_be_allocated_on_the_heap";
+	kept.GetComponent<Tracked>().value = 10;
+	kept.SetComponentEnabled<RawPosition>(false);
+	Junia::Entity::DestroyEntity(removed);
+	Junia::Entity added = Junia::Entity::Create();
+	added.AddComponent<Name>("added");
+
+	std::stringstream delta{ };
+	Junia::WriteDelta(baseline, delta);
+
+	std::istringstream restored(baselineBytes);
+	Junia::LoadSnapshot(restored);
+	EXPECT_EQ(kept.GetComponent<RawPosition>().y, 2.0F);
+	EXPECT_TRUE(removed.HasComponent<RawPosition>());
+	EXPECT_FALSE(added.HasComponent<Name>());
+
+	Junia::ApplyDelta(delta);
+	EXPECT_EQ(kept.GetComponent<RawPosition>().x, 1.0F);
+	EXPECT_EQ(kept.GetComponent<RawPosition>().y, 20.0F);
+	EXPECT_FALSE(kept.IsComponentEnabled<RawPosition>());
+	EXPECT_EQ(kept.GetComponent<Name>().value, "another_name_long_enough_to_be_allocated_on_the_heap");
+	EXPECT_EQ(kept.GetComponent<Name>().GetEntity().GetId(), kept.GetId());
+	EXPECT_EQ(kept.GetComponent<Tracked>().value, 10);
+	EXPECT_EQ(kept.GetComponent<Tracked>().GetEntity().GetId(), kept.GetId());
+	EXPECT_FALSE(removed.HasComponent<RawPosition>());
+	EXPECT_EQ(added.GetComponent<Name>().value, "added");
+	EXPECT_EQ(added.GetComponent<Name>().GetEntity().GetId(), added.GetId());
+	EXPECT_EQ(Tracked::live, 1);
+
+	Junia::World::SetActive(std::make_shared<Junia::World>());
+	EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST_F(SnapshotTest, TruncatedDeltaLeavesWorldUntouched) {
+	Junia::Entity entity = Junia::Entity::Create();
+	entity.AddComponent<RawPosition>(1.0F, 2.0F);
+	entity.AddComponent<Name>("baseline");
+
+	std::stringstream baseline{ };
+	Junia::SaveSnapshot(baseline);
+	entity.GetComponent<RawPosition>().x = 5.0F;
+	entity.GetComponent<Name>().value = "changed";
+	Junia::Entity::Create().AddComponent<RawPosition>();
+
+	std::stringstream delta{ };
+	Junia::WriteDelta(baseline, delta);
+	std::string bytes = delta.str();
+	bytes.resize(bytes.size() - 1);
+
+	entity.GetComponent<RawPosition>().x = 7.0F;
+	std::istringstream truncated(bytes);
+	EXPECT_THROW(Junia::ApplyDelta(truncated), std::runtime_error);
+	EXPECT_EQ(entity.GetComponent<RawPosition>().x, 7.0F);
+	EXPECT_EQ(entity.GetComponent<Name>().value, "changed");
+}
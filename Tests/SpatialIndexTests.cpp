@@ -0,0 +1,122 @@
+#include "ECS.hpp"
+#include "SpatialIndex.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Point : public Junia::Component {
+public:
+	float x = 0.0F;
+	float y = 0.0F;
+
+	Point() = default;
+
+	Point(float x, float y)
+		: x(x), y(y) { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+constexpr float CELL_SIZE = 4.0F;
+constexpr uint32_t RANDOM_SEED = 7;
+
+class SpatialIndexTest : public testing::Test {
+protected:
+	std::vector<Junia::Entity> entities{ };
+
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Point>();
+	}
+
+	static Junia::SpatialIndex<Point> CreateIndex() {
+		return Junia::SpatialIndex<Point>(CELL_SIZE, [](const Point& point) -> Junia::SpatialPoint {
+			return { point.x, point.y, 0.0F };
+		});
+	}
+
+	void CreateRandomPoints(size_t count) {
+		std::mt19937 random(RANDOM_SEED);
+		std::uniform_real_distribution<float> coordinate(-50.0F, 50.0F);
+		for (size_t i = 0; i < count; i++) {
+			entities.push_back(Junia::Entity::Create());
+			entities.back().AddComponent<Point>(coordinate(random), coordinate(random));
+		}
+	}
+
+	static float GetDistanceSquared(Junia::Entity entity, float x, float y) {
+		const Point& point = entity.ReadComponent<Point>();
+		return ((point.x - x) * (point.x - x)) + ((point.y - y) * (point.y - y));
+	}
+
+	static std::vector<Junia::EntityIdType> ToSortedIds(const std::vector<Junia::Entity>& found) {
+		std::vector<Junia::EntityIdType> ids{ };
+		for (const Junia::Entity entity : found) ids.push_back(entity.GetId());
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(SpatialIndexTest, RadiusQueryMatchesLinearScan) {
+	CreateRandomPoints(2000);
+	Junia::SpatialIndex<Point> index = CreateIndex();
+
+	for (const float radius : { 0.5F, 3.0F, 10.0F, 75.0F }) {
+		std::vector<Junia::EntityIdType> expected{ };
+		for (const Junia::Entity entity : entities) {
+			if (GetDistanceSquared(entity, -3.0F, 7.5F) <= radius * radius) expected.push_back(entity.GetId());
+		}
+		std::sort(expected.begin(), expected.end());
+		EXPECT_EQ(ToSortedIds(index.QueryRadius({ -3.0F, 7.5F, 0.0F }, radius)), expected);
+	}
+}
+
+TEST_F(SpatialIndexTest, NearestQueryIsOrderedByDistance) {
+	CreateRandomPoints(500);
+	Junia::SpatialIndex<Point> index = CreateIndex();
+
+	std::vector<Junia::Entity> expected = entities;
+	std::sort(expected.begin(), expected.end(), [](Junia::Entity a, Junia::Entity b) -> bool {
+		return GetDistanceSquared(a, 1.0F, 2.0F) < GetDistanceSquared(b, 1.0F, 2.0F);
+	});
+	const std::vector<Junia::Entity> nearest = index.QueryNearest({ 1.0F, 2.0F, 0.0F }, 10);
+	ASSERT_EQ(nearest.size(), 10U);
+	for (size_t i = 0; i < nearest.size(); i++) EXPECT_EQ(nearest[i].GetId(), expected[i].GetId());
+}
+
+TEST_F(SpatialIndexTest, BoxQueryIncludesBordersAndFollowsChanges) {
+	Junia::SpatialIndex<Point> index = CreateIndex();
+	Junia::Entity inside = Junia::Entity::Create();
+	inside.AddComponent<Point>(1.0F, 1.0F);
+	Junia::Entity border = Junia::Entity::Create();
+	border.AddComponent<Point>(2.0F, 0.0F);
+	Junia::Entity outside = Junia::Entity::Create();
+	outside.AddComponent<Point>(30.0F, 30.0F);
+
+	const Junia::SpatialPoint min{ 0.0F, 0.0F, 0.0F };
+	const Junia::SpatialPoint max{ 2.0F, 2.0F, 0.0F };
+	EXPECT_EQ(ToSortedIds(index.QueryAABB(min, max)),
+		(std::vector<Junia::EntityIdType>{ inside.GetId(), border.GetId() }));
+
+	// written components are read again before the next query
+	outside.GetComponent<Point>().x = 0.5F;
+	outside.GetComponent<Point>().y = 0.5F;
+	inside.RemoveComponent<Point>();
+	Junia::Entity::DestroyEntity(border);
+	EXPECT_EQ(ToSortedIds(index.QueryAABB(min, max)), std::vector<Junia::EntityIdType>{ outside.GetId() });
+}
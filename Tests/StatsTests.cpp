@@ -0,0 +1,85 @@
+#include "ECS.hpp"
+#include "Stats.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+class Mass : public Junia::Component {
+public:
+	float value = 1.0F;
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class StatsTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Mass>();
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(StatsTest, StoreAndEntityCountsFollowTheWorld) {
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 10; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Mass>();
+	}
+	Junia::Entity::DestroyEntity(entities[3]);
+
+	const Junia::WorldStats stats = Junia::World::GetActive()->GetStats();
+	EXPECT_EQ(stats.entities.liveCount, 9U);
+	EXPECT_EQ(stats.entities.freeCount, 1U);
+	ASSERT_EQ(stats.stores.size(), 1U);
+	EXPECT_EQ(stats.stores[0].liveCount, 9U);
+	EXPECT_EQ(stats.stores[0].holeCount, 1U);
+	EXPECT_EQ(stats.stores[0].sharedPageCount, 0U);
+}
+
+TEST_F(StatsTest, ForksReportSharedPages) {
+	Junia::Entity::Create().AddComponent<Mass>();
+	const std::shared_ptr<Junia::World> fork = Junia::World::GetActive()->Fork();
+
+	const Junia::WorldStats stats = fork->GetStats();
+	ASSERT_EQ(stats.stores.size(), 1U);
+	EXPECT_EQ(stats.stores[0].sharedPageCount, stats.stores[0].pageCount);
+}
+
+TEST_F(StatsTest, SystemTimersRecordFromSeveralThreads) {
+	constexpr int THREAD_COUNT = 4;
+	constexpr int RUNS_PER_THREAD = 1000;
+
+	std::vector<std::thread> threads{ };
+	for (int thread = 0; thread < THREAD_COUNT; thread++) {
+		threads.emplace_back([]() -> void {
+			for (int run = 0; run < RUNS_PER_THREAD; run++) {
+				const Junia::ScopedSystemTimer timer(run % 2 == 0 ? "Even" : "Odd");
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	const Junia::WorldStats stats = Junia::World::GetActive()->GetStats();
+#ifdef JUNIA_ECS_STATS
+	ASSERT_EQ(stats.systems.size(), 2U);
+	EXPECT_EQ(stats.systems[0].name, "Even");
+	EXPECT_EQ(stats.systems[0].calls, static_cast<uint64_t>(THREAD_COUNT * RUNS_PER_THREAD / 2));
+	EXPECT_EQ(stats.systems[1].calls, static_cast<uint64_t>(THREAD_COUNT * RUNS_PER_THREAD / 2));
+#else
+	EXPECT_TRUE(stats.systems.empty());
+#endif
+}
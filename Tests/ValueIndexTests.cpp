@@ -0,0 +1,127 @@
+#include "ECS.hpp"
+#include "ValueIndex.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief A key that is only ordered (no operator==)
+*/
+struct Rank {
+	int value = 0;
+
+	bool operator<(const Rank& other) const {
+		return value < other.value;
+	}
+};
+
+class Member : public Junia::Component {
+public:
+	int team = 0;
+	int rank = 0;
+
+	Member() = default;
+
+	Member(int team, int rank)
+		: team(team), rank(rank) { }
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class ValueIndexTest : public testing::Test {
+protected:
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Member>();
+	}
+
+	static std::vector<Junia::EntityIdType> ToSortedIds(const std::vector<Junia::Entity>& found) {
+		std::vector<Junia::EntityIdType> ids{ };
+		for (const Junia::Entity entity : found) ids.push_back(entity.GetId());
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(ValueIndexTest, HashIndexFollowsChangedAndRemovedComponents) {
+	Junia::Entity red = Junia::Entity::Create();
+	red.AddComponent<Member>(1, 0);
+	Junia::Entity blue = Junia::Entity::Create();
+	blue.AddComponent<Member>(2, 0);
+	Junia::ValueIndex<Member, int> index([](const Member& member) -> int { return member.team; });
+
+	EXPECT_EQ(index.Count(1), 1U);
+	EXPECT_EQ(index.FindFirst(2)->GetId(), blue.GetId());
+	EXPECT_FALSE(index.FindFirst(3).has_value());
+
+	blue.GetComponent<Member>().team = 1;
+	EXPECT_EQ(ToSortedIds(index.Find(1)), (std::vector<Junia::EntityIdType>{ red.GetId(), blue.GetId() }));
+	EXPECT_EQ(index.Count(2), 0U);
+
+	red.RemoveComponent<Member>();
+	EXPECT_EQ(ToSortedIds(index.Find(1)), std::vector<Junia::EntityIdType>{ blue.GetId() });
+	Junia::Entity::DestroyEntity(blue);
+	EXPECT_EQ(index.Count(1), 0U);
+}
+
+TEST_F(ValueIndexTest, HashIndexSurvivesRehashing) {
+	Junia::ValueIndex<Member, int> index([](const Member& member) -> int { return member.team; });
+
+	// every entity gets a key of its own, so the groups are rehashed several
+	// times while the first entities are listed in them
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 1000; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Member>(i, 0);
+		if (i % 100 == 0) EXPECT_EQ(index.Count(i), 1U);
+	}
+
+	for (int i = 0; i < 500; i++) entities[i].GetComponent<Member>().team = -1 - (i % 10);
+	for (int i = 500; i < 1000; i += 2) entities[i].RemoveComponent<Member>();
+	EXPECT_EQ(index.Count(0), 0U);
+	EXPECT_EQ(index.Count(-1), 50U);
+	EXPECT_EQ(index.Count(500), 0U);
+	EXPECT_EQ(index.FindFirst(501)->GetId(), entities[501].GetId());
+
+	for (int i = 0; i < 500; i += 2) Junia::Entity::DestroyEntity(entities[i]);
+	EXPECT_EQ(index.Count(-1), 0U);
+	EXPECT_EQ(index.Count(-2), 50U);
+	EXPECT_EQ(index.Count(999), 1U);
+}
+
+TEST_F(ValueIndexTest, SortedIndexOnlyNeedsOperatorLess) {
+	std::vector<Junia::Entity> entities{ };
+	for (int i = 0; i < 10; i++) {
+		entities.push_back(Junia::Entity::Create());
+		entities.back().AddComponent<Member>(0, 9 - i);
+	}
+	Junia::ValueIndex<Member, Rank, Junia::ValueIndexKind::Sorted> index(
+		[](const Member& member) -> Rank { return { member.rank }; });
+
+	EXPECT_EQ(index.FindFirst({ 0 })->GetId(), entities[9].GetId());
+	const std::vector<Junia::Entity> range = index.FindRange({ 2 }, { 4 });
+	ASSERT_EQ(range.size(), 3U);
+	EXPECT_EQ(range[0].GetId(), entities[7].GetId());
+	EXPECT_EQ(range[2].GetId(), entities[5].GetId());
+
+	// rewriting an equivalent key keeps the entity in its group
+	entities[0].GetComponent<Member>().team = 1;
+	EXPECT_EQ(index.Count({ 9 }), 1U);
+	entities[0].GetComponent<Member>().rank = 0;
+	EXPECT_EQ(index.Count({ 9 }), 0U);
+	EXPECT_EQ(index.Count({ 0 }), 2U);
+}
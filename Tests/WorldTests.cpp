@@ -0,0 +1,108 @@
+#include "ECS.hpp"
+#include "World.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --------------------------------- Components --------------------------------
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Counts its live instances, which only balances out if every
+ *        component is destroyed exactly once
+*/
+class Counted : public Junia::Component {
+public:
+	static inline int live = 0;
+
+	int value = 0;
+
+	Counted() {
+		live++;
+	}
+
+	explicit Counted(int value)
+		: value(value) {
+		live++;
+	}
+
+	Counted(const Counted& other)
+		: Component(other), value(other.value) {
+		live++;
+	}
+
+	~Counted() override {
+		live--;
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ---------------------------------- Fixture ----------------------------------
+// -----------------------------------------------------------------------------
+
+class ForkTest : public testing::Test {
+protected:
+	std::vector<Junia::Entity> entities{ };
+
+	void SetUp() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		Junia::Component::Register<Counted>();
+		for (int i = 0; i < 1000; i++) {
+			entities.push_back(Junia::Entity::Create());
+			entities.back().AddComponent<Counted>(i);
+		}
+	}
+
+	void TearDown() override {
+		Junia::World::SetActive(std::make_shared<Junia::World>());
+		EXPECT_EQ(Counted::live, 0);
+	}
+};
+
+// -----------------------------------------------------------------------------
+// ----------------------------------- Tests -----------------------------------
+// -----------------------------------------------------------------------------
+
+TEST_F(ForkTest, ForkSharesComponentsUntilWritten) {
+	const std::shared_ptr<Junia::World> original = Junia::World::GetActive();
+	const std::shared_ptr<Junia::World> fork = original->Fork();
+	EXPECT_EQ(Counted::live, 1000);
+
+	Junia::World::SetActive(fork);
+	entities[0].GetComponent<Counted>().value = -1;
+	EXPECT_EQ(entities[0].ReadComponent<Counted>().value, -1);
+	EXPECT_EQ(entities[999].ReadComponent<Counted>().value, 999);
+
+	Junia::World::SetActive(original);
+	EXPECT_EQ(entities[0].ReadComponent<Counted>().value, 0);
+}
+
+TEST_F(ForkTest, StructuralChangesStayInTheirWorld) {
+	const std::shared_ptr<Junia::World> original = Junia::World::GetActive();
+	const std::shared_ptr<Junia::World> fork = original->Fork();
+
+	Junia::World::SetActive(fork);
+	Junia::Entity::DestroyEntity(entities[1]);
+	EXPECT_FALSE(entities[1].HasComponent<Counted>());
+	// the destroyed id is handed out again in the fork only
+	Junia::Entity added = Junia::Entity::Create();
+	EXPECT_EQ(added.GetId(), entities[1].GetId());
+	added.AddComponent<Counted>(-2);
+
+	Junia::World::SetActive(original);
+	EXPECT_EQ(entities[1].ReadComponent<Counted>().value, 1);
+	EXPECT_EQ(Junia::Entity::Create().GetId(), entities.back().GetId() + 1);
+}
+
+TEST_F(ForkTest, DestroyingTheOriginalKeepsTheForkIntact) {
+	std::shared_ptr<Junia::World> fork = Junia::World::GetActive()->Fork();
+	Junia::World::SetActive(fork);
+	fork.reset();
+
+	EXPECT_EQ(Counted::live, 1000);
+	for (size_t i = 0; i < entities.size(); i++)
+		EXPECT_EQ(entities[i].ReadComponent<Counted>().value, static_cast<int>(i));
+}